@@ -0,0 +1,90 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Main.hpp"
+
+
+/// Link two ideas both ways                                                  
+static void Link(Idea* a, Idea* b) {
+   a->Associate(b);
+   b->Associate(a);
+}
+
+/// Build a chain of associated ideas                                         
+///   @param ontology - the ontology to build in                              
+///   @param prefix - distinguishes the ideas of different chains             
+///   @param length - number of ideas in the chain                            
+///   @return the ideas, in order                                             
+static auto Chain(Ontology& ontology, const char* prefix, Count length) -> ::std::vector<Idea*> {
+   const auto writer = ontology.Write();
+   ::std::vector<Idea*> chain;
+   for (Count i = 0; i < length; ++i) {
+      auto idea = ontology.Build(Many {Text {prefix} + MakeWord(i, 8)});
+      if (not chain.empty())
+         Link(chain.back(), idea);
+      chain.push_back(idea);
+   }
+   return chain;
+}
+
+/// Compare two ideas                                                         
+static void Compare(const Idea* lhs, Idea* rhs) {
+   Verbs::Equal equal {rhs};
+   lhs->Equal(equal);
+}
+
+/// Benchmark comparing ideas and extracting data from them                   
+///   @param bench - the harness                                              
+void BenchIdea(Bench& bench) {
+   Sandbox sandbox;
+   auto mind = sandbox.CreateMind();
+   auto& ontology = mind->GetOntology();
+   auto stranger = Chain(ontology, "stranger", 1)[0];
+
+   // Comparing the ends of a chain walks all of it, and so does        
+   // comparing with an unrelated idea                                  
+   for (Count depth : {8, 64, 512}) {
+      const auto chain = Chain(ontology, "chain", depth);
+      const auto view = ontology.Read();
+      const auto suffix = ::std::to_string(depth);
+
+      bench.Measure("Idea::Equal/chain/related/" + suffix, depth,
+         [&] { Compare(chain.front(), chain.back()); });
+
+      bench.Measure("Idea::Equal/chain/unrelated/" + suffix, depth,
+         [&] { Compare(chain.front(), stranger); });
+   }
+
+   // Hubs are associated with a lot of ideas, that all have to be      
+   // visited before an unrelated idea is rejected                      
+   for (Count degree : {64, 1024, 8192}) {
+      Idea* hub;
+      {
+         const auto writer = ontology.Write();
+         hub = ontology.Build(Many {Text {"hub"} + MakeWord(degree, 8)});
+         for (Count i = 0; i < degree; ++i)
+            Link(hub, ontology.Build(Many {Text {"spoke"} + MakeWord(i, 8)}));
+      }
+
+      const auto view = ontology.Read();
+      bench.Measure("Idea::Equal/hub/unrelated/" + ::std::to_string(degree), degree,
+         [&] { Compare(hub, stranger); });
+   }
+
+   // Extracting a verb at the end of a chain                           
+   for (Count depth : {1, 8, 64}) {
+      auto chain = Chain(ontology, "action", depth);
+      {
+         const auto writer = ontology.Write();
+         Link(chain.back(), ontology.Build(Many {Code {"create Thing"}}));
+      }
+
+      const auto view = ontology.Read();
+      bench.Measure("Idea::Extract<Verb>/" + ::std::to_string(depth), depth,
+         [&] { chain.front()->Extract<Verb>(); });
+   }
+}
@@ -0,0 +1,68 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Main.hpp"
+
+
+/// Benchmark minds compiling interpretations and doing things                
+///   @param bench - the harness                                              
+void BenchMind(Bench& bench) {
+   Sandbox sandbox;
+   auto mind = sandbox.CreateMind();
+   auto& ontology = mind->GetOntology();
+
+   // Words that mean actions, so that compiled programs contain verbs  
+   ::std::vector<Text> words;
+   {
+      const auto writer = ontology.Write();
+      const auto action = ontology.Build(Many {Code {"create Thing"}});
+      for (Count w = 0; w < 64; ++w) {
+         const auto word = MakeWord(w, 3 + w % 6);
+         const auto idea = ontology.Build(Many {word});
+         if (w % 4 == 0) {
+            idea->Associate(action);
+            action->Associate(idea);
+         }
+         words.push_back(word);
+      }
+   }
+
+   // Compiling interpretations of various lengths into programs, and   
+   // interpreting and compiling them from text                         
+   Program program;
+   for (Count length : {16, 64}) {
+      Text text;
+      for (Count w = 0; text.GetCount() < length; ++w) {
+         if (text)
+            text += " ";
+         text += words[(w * 7) % words.size()];
+      }
+
+      const auto interpretation = mind->Interpret(text);
+      const auto suffix = ::std::to_string(length);
+
+      bench.Measure("Mind::Compile/" + suffix, 1,
+         [&] { mind->Compile(interpretation, program); });
+
+      bench.Measure("Mind::Interpret/" + suffix, length,
+         [&] { mind->Interpret(text); });
+
+      bench.Measure("Mind::Interpret/program/" + suffix, length,
+         [&] { mind->Interpret(text, program); });
+   }
+
+   // Doing a frame's worth of verbs, and recording them in history     
+   static constexpr Count Frame = 256;
+   const auto construct = Construct::From<Idea>(Many {words[0]});
+   bench.Measure("Mind::Do/" + ::std::to_string(Frame), Frame, [&] {
+      for (Count i = 0; i < Frame; ++i) {
+         Verbs::Create creation {construct};
+         mind->Do(creation);
+      }
+      mind->Update({});
+   });
+}
@@ -0,0 +1,152 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Main.hpp"
+#include "Synthetic.hpp"
+#include <optional>
+
+
+/// Build a vocabulary of words, and a sentence made of them                  
+///   @param ontology - the ontology to build the words in                    
+///   @param words - number of distinct words                                 
+///   @param length - number of characters in the sentence                    
+///   @param ambiguous - whether all prefixes of the words are ideas, too,    
+///      so that each sentence can be split in many ways                      
+///   @return the sentence                                                    
+static auto Vocabulary(Ontology& ontology, Count words, Count length, bool ambiguous) -> Text {
+   const auto writer = ontology.Write();
+   ::std::vector<Text> vocabulary;
+   for (Count w = 0; w < words; ++w) {
+      const auto word = MakeWord(w, 3 + w % 6);
+      ontology.Build(Many {word});
+      if (ambiguous) {
+         for (Count p = 1; p < word.GetCount(); ++p)
+            ontology.Build(Many {Text {word.Select(0, p)}});
+      }
+      vocabulary.push_back(word);
+   }
+
+   Text sentence;
+   for (Count w = 0; sentence.GetCount() < length; w = (w * 7 + 3) % words) {
+      if (sentence)
+         sentence += " ";
+      sentence += vocabulary[w];
+   }
+   return Text {sentence.Select(0, length)};
+}
+
+/// Learn something unrelated, so that the ontology begins a new epoch, and   
+/// nothing is cached anymore                                                 
+///   @param ontology - the ontology                                          
+///   @param next - [in/out] a counter, to learn something new each time      
+static void NewEpoch(Ontology& ontology, ::std::uint64_t& next) {
+   const auto writer = ontology.Write();
+   const auto name = "#epoch" + ::std::to_string(next++);
+   ontology.Build(Many {Text {name.c_str()}});
+}
+
+/// Benchmark building, interpreting and destroying ontologies                
+///   @param bench - the harness                                              
+void BenchOntology(Bench& bench) {
+   // Interpretation, depending on the length of the text and how many  
+   // ways it can be split into ideas. Cold interpretations start in a  
+   // new epoch, so that nothing is cached                              
+   for (bool ambiguous : {false, true}) {
+      Ontology ontology;
+      ::std::uint64_t epochs = 0;
+      const auto kind = ::std::string {ambiguous ? "ambiguous" : "distinct"};
+
+      for (Count length : {16, 64, 128}) {
+         const auto text = Vocabulary(ontology, 256, length, ambiguous);
+         const auto suffix = kind + '/' + ::std::to_string(length);
+
+         bench.Measure("Ontology::Interpret/cold/" + suffix, length,
+            [&] { NewEpoch(ontology, epochs); },
+            [&] { ontology.Interpret(text); });
+
+         bench.Measure("Ontology::Interpret/cached/" + suffix, length,
+            [&] { ontology.Interpret(text); });
+      }
+
+      ontology.Teardown();
+   }
+
+   // Building ideas that are new, and ideas that are already known     
+   {
+      Ontology ontology;
+      ::std::uint64_t next = 0;
+      Text word;
+
+      {
+         const auto writer = ontology.Write();
+
+         bench.Measure("Ontology::Build/new", 1,
+            [&] { word = MakeWord(next++, 12); },
+            [&] { ontology.Build(Many {word}); });
+
+         bench.Measure("Ontology::Build/known", 1,
+            [&] { word = MakeWord(next++ % 1024, 12); },
+            [&] { ontology.Build(Many {word}); });
+
+         // Mixed case text is built twice, and its variants associated 
+         bench.Measure("Ontology::BuildText/lowercase", 1,
+            [&] { word = MakeWord(next++, 12); },
+            [&] { ontology.BuildText(word); });
+
+         bench.Measure("Ontology::BuildText/mixed", 1,
+            [&] { word = Text {"A"} + MakeWord(next++, 11); },
+            [&] { ontology.BuildText(word); });
+      }
+
+      ontology.Teardown();
+   }
+
+   // Interpreting a skewed workload on a large synthetic ontology, with
+   // hubs, so that popular words are asked about more often            
+   {
+      Ontology ontology;
+      Synthetic::Config config;
+      config.mVocabulary = 100000;
+      config.mSkew = 1.1;
+      Synthetic synthetic {config};
+      synthetic.Generate(ontology);
+
+      Synthetic::Workload workload;
+      workload.mQueries = 1024;
+      const auto queries = synthetic.Queries(workload);
+      Offset next = 0;
+      ::std::uint64_t epochs = 0;
+
+      bench.Measure("Ontology::Interpret/synthetic/100000", 1,
+         [&] { NewEpoch(ontology, epochs); },
+         [&] { ontology.Interpret(queries[next++ % queries.size()]); });
+
+      ontology.Teardown();
+   }
+
+   // Tearing down ontologies of various sizes                          
+   for (Count size : {1000, 10000}) {
+      ::std::optional<Ontology> scratch;
+
+      bench.Measure("Ontology::Teardown/" + ::std::to_string(size), size,
+         [&] {
+            scratch.emplace();
+            const auto writer = scratch->Write();
+            Idea* previous = nullptr;
+            for (Count i = 0; i < size; ++i) {
+               auto idea = scratch->Build(Many {MakeWord(i, 10)});
+               if (previous)
+                  idea->Associate(previous);
+               previous = idea;
+            }
+         },
+         [&] {
+            scratch->Teardown();
+            scratch.reset();
+         });
+   }
+}
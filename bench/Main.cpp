@@ -0,0 +1,149 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Main.hpp"
+#include <Langulus/AI.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <thread>
+
+LANGULUS_RTTI_BOUNDARY(RTTI::MainBoundary)
+
+
+/// Prepare the harness                                                       
+///   @param filter - only benchmarks containing this are run                 
+///   @param minTime - seconds to spend sampling each benchmark               
+Bench::Bench(::std::string filter, double minTime)
+   : mFilter  {::std::move(filter)}
+   , mMinTime {minTime} {}
+
+/// Check if a benchmark was selected to run                                  
+///   @param name - name of the benchmark                                     
+///   @return true if the benchmark should run                                
+bool Bench::Wants(const ::std::string& name) const {
+   return mFilter.empty() or name.find(mFilter) != ::std::string::npos;
+}
+
+/// Summarize the samples of a benchmark                                      
+///   @param name - name of the benchmark                                     
+///   @param samples - [in/out] nanoseconds per iteration of each sample      
+///   @param iterations - total number of iterations sampled                  
+///   @param items - number of items processed by a single iteration          
+void Bench::Report(::std::string&& name, ::std::vector<double>& samples, Count iterations, Count items) {
+   ::std::sort(samples.begin(), samples.end());
+   double sum = 0;
+   for (auto sample : samples)
+      sum += sample;
+
+   Result result;
+   result.mName = ::std::move(name);
+   result.mIterations = iterations;
+   result.mMean = sum / static_cast<double>(samples.size());
+   result.mMedian = samples[samples.size() / 2];
+   result.mMin = samples.front();
+   result.mMax = samples.back();
+   result.mItemsPerSecond = result.mMedian > 0
+      ? static_cast<double>(items) * 1e9 / result.mMedian : 0;
+
+   Logger::Info(result.mName.c_str(), ": ", result.mMedian, " ns median, ",
+      result.mItemsPerSecond, " items/s");
+   mResults.emplace_back(::std::move(result));
+}
+
+/// Save all results as JSON                                                  
+///   @param path - the file to write to                                      
+///   @return true if the file was written                                    
+bool Bench::Save(const char* path) const {
+   ::std::ofstream file {path};
+   if (not file) {
+      Logger::Error("Can't open `", path, "` for writing results");
+      return false;
+   }
+
+   char date[32];
+   const auto now = ::std::time(nullptr);
+   ::std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", ::std::localtime(&now));
+
+   file << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"executable\": \"LangulusModAIBench\",\n"
+        << "    \"num_cpus\": " << ::std::thread::hardware_concurrency() << ",\n"
+      #ifdef NDEBUG
+        << "    \"library_build_type\": \"release\",\n"
+      #else
+        << "    \"library_build_type\": \"debug\",\n"
+      #endif
+        << "    \"metrics\": " << (LANGULUS_MOD_AI_METRICS ? "true" : "false") << ",\n"
+        << "    \"trace\": " << (LANGULUS_MOD_AI_TRACE ? "true" : "false") << "\n"
+        << "  },\n  \"benchmarks\": [";
+
+   bool first = true;
+   for (auto& result : mResults) {
+      file << (first ? "\n" : ",\n")
+           << "    {\"name\": \"" << result.mName << "\", "
+           << "\"run_type\": \"iteration\", "
+           << "\"iterations\": " << result.mIterations << ", "
+           << "\"real_time\": " << result.mMedian << ", "
+           << "\"mean_time\": " << result.mMean << ", "
+           << "\"min_time\": " << result.mMin << ", "
+           << "\"max_time\": " << result.mMax << ", "
+           << "\"time_unit\": \"ns\", "
+           << "\"items_per_second\": " << result.mItemsPerSecond << "}";
+      first = false;
+   }
+
+   file << "\n  ]\n}\n";
+   return static_cast<bool>(file);
+}
+
+/// Tear down the sandboxed module, along with all its minds                  
+Sandbox::~Sandbox() {
+   mModule.Teardown();
+}
+
+/// Create a mind in the sandboxed module                                     
+///   @return the new mind                                                    
+auto Sandbox::CreateMind() -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   mModule.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+/// Generate a deterministic lowercase word                                   
+///   @param seed - the same seed always generates the same word              
+///   @param length - number of letters                                       
+///   @return the word                                                        
+auto MakeWord(::std::uint64_t seed, Count length) -> Text {
+   ::std::string word;
+   for (Count i = 0; i < length; ++i) {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      word += static_cast<char>('a' + (seed >> 33) % 26);
+   }
+   return Text {word.c_str()};
+}
+
+
+///                                                                           
+///   Microbenchmarks of the AI module                                        
+///                                                                           
+///   Usage: LangulusModAIBench [results.json] [filter] [seconds]             
+///                                                                           
+/// Runs all benchmarks whose name contains the filter, sampling each of them 
+/// for the given number of seconds, and saves the results as JSON            
+///                                                                           
+int main(int argc, char** argv) {
+   const char* path = argc > 1 ? argv[1] : "LangulusModAIBench.json";
+   Bench bench {argc > 2 ? argv[2] : "", argc > 3 ? ::std::atof(argv[3]) : 0.5};
+
+   BenchOntology(bench);
+   BenchIdea(bench);
+   BenchMind(bench);
+
+   return bench.Save(path) ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../source/AI.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace Langulus;
+
+
+///                                                                           
+///   Microbenchmark harness                                                  
+///                                                                           
+/// Each benchmark is calibrated to run in batches long enough to be timed    
+/// reliably, and is then sampled several times. Results are reported as      
+/// nanoseconds per iteration, and saved as JSON in the same layout Google    
+/// Benchmark uses, so that existing tools can compare releases               
+///                                                                           
+struct Bench {
+private:
+   using Clock = ::std::chrono::steady_clock;
+   using Nanoseconds = ::std::chrono::duration<double, ::std::nano>;
+
+   struct Result {
+      ::std::string mName;
+      Count mIterations;
+      double mMean;
+      double mMedian;
+      double mMin;
+      double mMax;
+      double mItemsPerSecond;
+   };
+
+   ::std::vector<Result> mResults;
+   ::std::string mFilter;
+   double mMinTime;
+   Count mSamples = 16;
+
+   bool Wants(const ::std::string&) const;
+   void Report(::std::string&&, ::std::vector<double>&, Count iterations, Count items);
+
+   /// Calibrate and sample a benchmark                                       
+   ///   @param name - name of the benchmark                                  
+   ///   @param items - number of items processed by a single iteration       
+   ///   @param batch - runs a number of iterations, returns nanoseconds      
+   template<class F>
+   void Run(::std::string&& name, Count items, F&& batch) {
+      if (not Wants(name))
+         return;
+
+      // Grow the batch until a sample takes long enough                
+      const double target = mMinTime * 1e9 / static_cast<double>(mSamples);
+      Count iterations = 1;
+      while (iterations < (Count {1} << 30)) {
+         const double elapsed = batch(iterations);
+         if (elapsed >= target)
+            break;
+         iterations *= elapsed > 0 and target / elapsed < 10 ? 2 : 10;
+      }
+
+      ::std::vector<double> samples;
+      for (Count s = 0; s < mSamples; ++s)
+         samples.push_back(batch(iterations) / static_cast<double>(iterations));
+      Report(::std::move(name), samples, iterations * mSamples, items);
+   }
+
+public:
+   Bench(::std::string filter, double minTime);
+
+   /// Measure a piece of code                                                
+   ///   @param name - name of the benchmark                                  
+   ///   @param items - number of items processed by a single call            
+   ///   @param body - the code to measure                                    
+   template<class F>
+   void Measure(::std::string name, Count items, F&& body) {
+      Run(::std::move(name), items, [&](Count iterations) {
+         const auto start = Clock::now();
+         for (Count i = 0; i < iterations; ++i)
+            body();
+         return Nanoseconds {Clock::now() - start}.count();
+      });
+   }
+
+   /// Measure a piece of code, that needs to be prepared each time, without  
+   /// measuring the preparation                                              
+   ///   @param name - name of the benchmark                                  
+   ///   @param items - number of items processed by a single call            
+   ///   @param setup - prepares for a single call, not measured              
+   ///   @param body - the code to measure                                    
+   template<class S, class F>
+   void Measure(::std::string name, Count items, S&& setup, F&& body) {
+      Run(::std::move(name), items, [&](Count iterations) {
+         Clock::duration elapsed {};
+         for (Count i = 0; i < iterations; ++i) {
+            setup();
+            const auto start = Clock::now();
+            body();
+            elapsed += Clock::now() - start;
+         }
+         return Nanoseconds {elapsed}.count();
+      });
+   }
+
+   bool Save(const char*) const;
+};
+
+
+///                                                                           
+///   A module instance without a runtime, for benchmarking minds             
+///                                                                           
+struct Sandbox {
+   AI mModule {nullptr, Many {}};
+
+   ~Sandbox();
+   auto CreateMind() -> Mind*;
+};
+
+auto MakeWord(::std::uint64_t seed, Count length) -> Text;
+
+void BenchOntology(Bench&);
+void BenchIdea(Bench&);
+void BenchMind(Bench&);
@@ -0,0 +1,222 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Synthetic.hpp"
+#include "../source/inner/Ontology.hpp"
+#include <cmath>
+#include <limits>
+#include <string>
+
+
+/// Advance a SplitMix64 generator - unlike the standard distributions, it    
+/// generates the same numbers with every standard library                    
+///   @param state - [in/out] the generator's state                           
+///   @return the next random number                                          
+static auto Next(::std::uint64_t& state) noexcept -> ::std::uint64_t {
+   auto x = (state += 0x9E3779B97F4A7C15ull);
+   x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+   x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+   return x ^ (x >> 31);
+}
+
+/// Generate a random real number                                             
+///   @param state - [in/out] the generator's state                           
+///   @return a number in the range [0; 1)                                    
+static auto Uniform(::std::uint64_t& state) noexcept -> Real {
+   return static_cast<Real>(Next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/// Generate a random index                                                   
+///   @param state - [in/out] the generator's state                           
+///   @param count - number of indices                                        
+///   @return an index in the range [0; count)                                
+static auto Below(::std::uint64_t& state, Count count) noexcept -> Offset {
+   return static_cast<Offset>(Next(state) % count);
+}
+
+
+/// Prepare a generator, and draw its vocabulary                              
+///   @param config - what to generate - tokens are at least a letter long,   
+///      and there are fewer of them than ideas can be linked by              
+Synthetic::Synthetic(const Config& config)
+   : mConfig {config} {
+   if (not mConfig.mMinLength)
+      mConfig.mMinLength = 1;
+   if (mConfig.mMaxLength < mConfig.mMinLength)
+      mConfig.mMaxLength = mConfig.mMinLength;
+   if (mConfig.mVocabulary >= ::std::numeric_limits<::std::uint32_t>::max()) {
+      Logger::Error("Can't generate ", mConfig.mVocabulary, " ideas - too many");
+      mConfig.mVocabulary = 0;
+   }
+
+   // Short tokens often collide - draw them again, until a new token   
+   // is found, so that the vocabulary has the requested size. Tokens   
+   // are drawn here, so that they're the same, whether queries are     
+   // generated before, or after the ontology                           
+   mAttempts.assign(mConfig.mVocabulary, 0);
+   mVocabulary.reserve(mConfig.mVocabulary);
+   for (Offset i = 0; i < mConfig.mVocabulary; ++i) {
+      auto& attempt = mAttempts[i];
+      auto token = MakeToken(i, attempt);
+      while (mVocabulary.contains(token) and attempt + 1 < MaxAttempts)
+         token = MakeToken(i, ++attempt);
+      mVocabulary.insert(::std::move(token));
+   }
+}
+
+/// Pick a token by popularity, following a power law - lower indices are     
+/// more popular, unless the skew is zero                                     
+///   @param state - [in/out] the generator's state                           
+///   @param skew - exponent of the power law                                 
+///   @return the index of the token                                          
+auto Synthetic::Pick(::std::uint64_t& state, Real skew) const -> Offset {
+   const auto count = mConfig.mVocabulary;
+   if (skew <= 0)
+      return Below(state, count);
+
+   // Invert the continuous power law over [1; count + 1)               
+   const auto u = Uniform(state);
+   const auto n = static_cast<Real>(count + 1);
+   const auto x = ::std::abs(skew - 1) < 1e-6
+      ? ::std::exp(u * ::std::log(n))
+      : ::std::pow(u * (::std::pow(n, 1 - skew) - 1) + 1, 1 / (1 - skew));
+   const auto index = static_cast<Offset>(x) - 1;
+   return index < count ? index : count - 1;
+}
+
+/// Get a token of the vocabulary - tokens past the vocabulary size are       
+/// valid, too, and are words that are never part of the vocabulary           
+///   @param index - the index of the token                                   
+///   @return the token                                                       
+auto Synthetic::GetToken(Offset index) const -> Text {
+   if (index < mAttempts.size())
+      return Text {MakeToken(index, mAttempts[index]).c_str()};
+
+   // Draw unknown tokens again while they're known, and if that isn't  
+   // enough, lengthen them until they aren't                           
+   ::std::uint8_t attempt = 0;
+   auto token = MakeToken(index, attempt);
+   while (mVocabulary.contains(token) and ++attempt < MaxAttempts)
+      token = MakeToken(index, attempt);
+   while (mVocabulary.contains(token))
+      token += static_cast<char>('a' + token.size() % 26);
+   return Text {token.c_str()};
+}
+
+/// Generate a token                                                          
+///   @param index - the index of the token                                   
+///   @param attempt - generates a different token for the same index         
+///   @return the token                                                       
+auto Synthetic::MakeToken(Offset index, ::std::uint8_t attempt) const -> ::std::string {
+   ::std::uint64_t state = mConfig.mSeed
+      ^ (index * 0xD1B54A32D192ED03ull)
+      ^ (attempt * 0x8CB92BA72F3D8DD7ull);
+
+   // Geometric distribution of the letters past the minimum            
+   auto length = mConfig.mMinLength;
+   const auto extra = mConfig.mMeanLength - static_cast<Real>(mConfig.mMinLength);
+   if (extra > 0) {
+      const auto p = 1 / (extra + 1);
+      const auto u = Uniform(state);
+      const auto letters = ::std::floor(::std::log(1 - u) / ::std::log(1 - p));
+      const auto limit = static_cast<Real>(mConfig.mMaxLength - mConfig.mMinLength);
+      length += static_cast<Count>(letters < limit ? letters : limit);
+   }
+
+   ::std::string token;
+   token.reserve(length);
+   for (Count i = 0; i < length; ++i)
+      token += static_cast<char>('a' + Below(state, 26));
+   return token;
+}
+
+/// Generate the ontology, by building each token, and linking the ideas      
+///   @param ontology - the ontology to generate in                           
+///   @return the idea of each token, in order - tokens share an idea only if 
+///      no different token was drawn in a few attempts, or if the ontology   
+///      already knew them                                                    
+auto Synthetic::Generate(Ontology& ontology) const -> Ideas {
+   const auto count = mConfig.mVocabulary;
+   const auto writer = ontology.Write();
+   Ideas ideas;
+   ideas.Reserve(count);
+   for (Offset i = 0; i < count; ++i)
+      ideas << ontology.Build(Many {GetToken(i)});
+
+   // Each link starts from the ideas in turn, so that every idea gets  
+   // about the same number of links started from it, and ends in an    
+   // idea picked by popularity - or in a neighbour of the last idea    
+   // linked to, which closes a cycle. Only the last link of each idea  
+   // is remembered, so that memory stays linear                        
+   static constexpr auto None = ::std::numeric_limits<::std::uint32_t>::max();
+   ::std::vector<::std::uint32_t> last(count, None);
+   ::std::uint64_t state = mConfig.mSeed;
+   const auto links = static_cast<Count>(static_cast<Real>(count) * mConfig.mDegree / 2);
+
+   for (Offset l = 0; l < links and count > 1; ++l) {
+      const auto from = l % count;
+      Offset to;
+      if (Uniform(state) < mConfig.mCycles and last[from] != None
+      and last[last[from]] != None and last[last[from]] != from)
+         to = last[last[from]];
+      else
+         to = Pick(state, mConfig.mSkew);
+
+      const bool associate = Uniform(state) >= mConfig.mDisassociations;
+      if (ideas[from] == ideas[to])
+         continue;
+
+      // Links are always symmetrical                                   
+      if (associate) {
+         ideas[from]->Associate(ideas[to]);
+         ideas[to]->Associate(ideas[from]);
+      }
+      else {
+         ideas[from]->Disassociate(ideas[to]);
+         ideas[to]->Disassociate(ideas[from]);
+      }
+
+      last[from] = static_cast<::std::uint32_t>(to);
+      last[to] = static_cast<::std::uint32_t>(from);
+   }
+
+   return ideas;
+}
+
+/// Generate queries about the ontology                                       
+///   @param workload - what queries to generate                              
+///   @return the queries - words separated by spaces                         
+auto Synthetic::Queries(const Workload& workload) const -> ::std::vector<Text> {
+   if (not mConfig.mVocabulary)
+      return {};
+
+   const auto minWords = workload.mMinWords ? workload.mMinWords : 1;
+   const auto maxWords = workload.mMaxWords > minWords ? workload.mMaxWords : minWords;
+   ::std::uint64_t state = workload.mSeed;
+   ::std::vector<Text> queries;
+   queries.reserve(workload.mQueries);
+
+   for (Count q = 0; q < workload.mQueries; ++q) {
+      const auto words = minWords + Below(state, maxWords - minWords + 1);
+
+      Text query;
+      for (Count w = 0; w < words; ++w) {
+         if (w)
+            query += " ";
+
+         // Tokens past the vocabulary are unknown to the ontology      
+         if (Uniform(state) < workload.mUnknown)
+            query += GetToken(mConfig.mVocabulary + Below(state, mConfig.mVocabulary + 1));
+         else
+            query += GetToken(Pick(state, workload.mSkew));
+      }
+
+      queries.emplace_back(::std::move(query));
+   }
+
+   return queries;
+}
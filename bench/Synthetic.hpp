@@ -0,0 +1,86 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../source/inner/Links.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+struct Ontology;
+
+
+///                                                                           
+///   Synthetic ontology generator                                            
+///                                                                           
+/// Generates ontologies of any size, together with matching workloads, for   
+/// scaling experiments. Everything is derived from a seed by its own random  
+/// generator, instead of the standard distributions, so the same seed and    
+/// configuration generate the same ontology and queries with any library.    
+///                                                                           
+/// Tokens are random lowercase words, and each of them is built into an      
+/// idea. Links connect either an idea picked by popularity, so that a power  
+/// law grows hubs, or a neighbour of a neighbour, which closes a cycle.      
+///                                                                           
+struct Synthetic {
+   struct Config {
+      // Seed of all random choices                                     
+      ::std::uint64_t mSeed = 1;
+      // Number of tokens, each of them a different idea, unless there  
+      // aren't enough different tokens of the allowed lengths          
+      Count mVocabulary = 10000;
+      // Token lengths are geometrically distributed, starting from the 
+      // minimum, with the given mean, and truncated at the maximum     
+      Count mMinLength = 2;
+      Count mMaxLength = 16;
+      Real mMeanLength = 6;
+      // Mean number of links of each idea                              
+      Real mDegree = 4;
+      // Exponent of the power law ideas are linked by - zero links     
+      // uniformly, and higher values grow bigger hubs                  
+      Real mSkew = 0;
+      // Fraction of the links that are disassociations                 
+      Real mDisassociations = 0.05;
+      // Probability of a link closing a cycle with linked ideas        
+      Real mCycles = 0.1;
+   };
+
+   struct Workload {
+      // Seed of all random choices, independent of the ontology's      
+      ::std::uint64_t mSeed = 1;
+      Count mQueries = 1000;
+      // Number of words in each query, picked uniformly                
+      Count mMinWords = 1;
+      Count mMaxWords = 8;
+      // Exponent of the power law words are picked by, so that some    
+      // of them are asked about a lot more often than others           
+      Real mSkew = 1;
+      // Fraction of the words that aren't in the vocabulary            
+      Real mUnknown = 0.1;
+   };
+
+private:
+   Config mConfig;
+
+   // Tokens that collide with earlier ones are generated again, and    
+   // the number of attempts it took is kept for each token             
+   static constexpr ::std::uint8_t MaxAttempts = 16;
+   ::std::vector<::std::uint8_t> mAttempts;
+   // All tokens of the vocabulary, so that unknown ones never match    
+   ::std::unordered_set<::std::string> mVocabulary;
+
+   auto Pick(::std::uint64_t& state, Real skew) const -> Offset;
+   auto MakeToken(Offset, ::std::uint8_t attempt) const -> ::std::string;
+
+public:
+   Synthetic(const Config&);
+
+   auto GetToken(Offset) const -> Text;
+   auto Generate(Ontology&) const -> Ideas;
+   auto Queries(const Workload&) const -> ::std::vector<Text>;
+};
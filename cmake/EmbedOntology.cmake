@@ -0,0 +1,17 @@
+# Converts a binary ontology image into a C++ source file
+# Invoked at build time by langulus_ai_compile_ontology, with:
+#	INPUT	- the ontology image
+#	OUTPUT	- the C++ file to generate
+#	NAME	- the symbol to define
+file(READ ${INPUT} IMAGE_HEX HEX)
+string(LENGTH "${IMAGE_HEX}" IMAGE_HEX_LENGTH)
+math(EXPR IMAGE_SIZE "${IMAGE_HEX_LENGTH} / 2")
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," IMAGE_BYTES "${IMAGE_HEX}")
+string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){32})" "\\1\n\t" IMAGE_BYTES "${IMAGE_BYTES}")
+
+file(WRITE ${OUTPUT}
+	"// Generated from ${INPUT} - do not edit\n"
+	"#include <cstddef>\n\n"
+	"alignas(8) extern const unsigned char ${NAME}[] = {\n\t${IMAGE_BYTES}\n};\n"
+	"extern const ::std::size_t ${NAME}Size = ${IMAGE_SIZE};\n"
+)
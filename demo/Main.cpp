@@ -25,7 +25,6 @@ int main(int, char**) {
 
    // Create the mind and build a common ontology for all demos         
    // Let's prove how scalable this strategy really is ;)               
-   auto mind = root.CreateUnit<A::Mind>();
    BuildOntology(root);
 
    // Pick a demo                                                       
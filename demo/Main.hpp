@@ -6,9 +6,15 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #include <Langulus/Entity/Thing.hpp>
+#include <Langulus/Anyness/Bytes.hpp>
+#include <cstddef>
 
 using namespace Langulus;
 
+// Ontology image, compiled from Ontology.code at build time
+extern const unsigned char DemoOntology[];
+extern const ::std::size_t DemoOntologySize;
+
 
 void BuildOntology(Thing&);
 void Demo01(Thing&);
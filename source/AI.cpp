@@ -10,13 +10,7 @@
 #include <Langulus/Math/Color.hpp>
 #include <Langulus/Math/Range.hpp>
 #include <Langulus/Math/Number.hpp>
-
-LANGULUS_DEFINE_MODULE(
-   AI, 0, "AI",
-   "Artificial intelligence module - "
-   "allows for simulating minds and societies", "",
-   AI, Society, Mind, Idea
-)
+#include <algorithm>
 
 
 /// Module construction                                                       
@@ -36,6 +30,9 @@ AI::AI(Runtime* runtime, const Many&)
 
 /// First stage destruction                                                   
 void AI::Teardown() {
+   mWorkers.SetThreadCount(1);
+   mBackground.Stop();
+   mKinship.Reset();
    mMinds.Teardown();
    mSocieties.Teardown();
 }
@@ -45,11 +42,156 @@ void AI::Teardown() {
 ///   @return false                                                           
 bool AI::Update(Time deltaTime) {
    LANGULUS(PROFILE);
-   for (auto& minds : mMinds)
-      minds.Update(deltaTime);
+
+   // Minds only touch their own state while updating, so they can be   
+   // updated in parallel. Batches don't depend on the number of        
+   // threads, so the result is the same as updating them in sequence   
+   mUpdated.clear();
+   for (auto& mind : mMinds) {
+      // Events shared with a society are stored in it beforehand, so   
+      // that members only read the society's history while updating    
+      mind.Chronicle();
+      mUpdated.emplace_back(&mind);
+   }
+
+   for (auto& society : mSocieties)
+      society.Record();
+
+   mWorkers.ForEach(mUpdated.size(), mBatchSize, [&](Offset i) {
+      mUpdated[i]->Update(deltaTime);
+   });
+
+   for (auto& society : mSocieties)
+      society.Update(deltaTime);
+
+   if (mKinInterval and ++mSinceGathering >= mKinInterval) {
+      mSinceGathering = 0;
+      FormSocieties();
+   }
    return false;
 }
 
+/// Gather minds with a lot of knowledge in common into societies. Minds      
+/// are never compared pairwise - see Kinship. Societies are signed by their  
+/// shared ontology, because members forget what was promoted to it. A group  
+/// that has a society admits its homeless minds into it, otherwise a new     
+/// society is produced for the group. Afterwards, each society promotes what 
+/// most of its members know to its shared ontology                           
+void AI::FormSocieties() {
+   TUnorderedMap<const Ontology*, Mind*> mindOf;
+   for (auto& mind : mMinds) {
+      // Ideas of paged ontologies aren't all resident                  
+      if (not mind.GetOntology().IsPaged())
+         mindOf.Insert(&mind.GetOntology(), &mind);
+   }
+
+   TUnorderedMap<const Ontology*, Society*> societyOf;
+   for (auto& society : mSocieties)
+      societyOf.Insert(&society.GetOntology(), &society);
+
+   // Forget destroyed minds before signing anything                    
+   mKinship.ForgetIf([&](const Ontology* ontology) {
+      return not mindOf.ContainsKey(ontology)
+         and not societyOf.ContainsKey(ontology);
+   });
+   for (auto& mind : mMinds) {
+      if (mindOf.ContainsKey(&mind.GetOntology()))
+         mKinship.Sign(mind.GetOntology());
+   }
+   for (auto& society : mSocieties)
+      mKinship.Sign(society.GetOntology());
+
+   // Groups are checked against the minimum here, where a society      
+   // counts as all of its members                                      
+   for (auto& group : mKinship.Gather(mKinThreshold, 2)) {
+      Society* society = nullptr;
+      Count homeless = 0;
+      for (auto ontology : group) {
+         if (societyOf.ContainsKey(ontology)) {
+            if (not society)
+               society = societyOf[ontology];
+            continue;
+         }
+
+         const auto& societies = mindOf[ontology]->GetSocieties();
+         if (not societies)
+            ++homeless;
+         else if (not society)
+            society = societies[0];
+      }
+
+      const auto members = society ? society->GetMinds().GetCount() : 0;
+      if (not homeless or homeless + members < ::std::max<Count>(mKinMinimum, 2))
+         continue;
+
+      if (not society) {
+         society = mSocieties.CreateOne(this, Many {});
+         VERBOSE_AI("Formed a society of ", group.size(), " minds");
+      }
+
+      for (auto ontology : group) {
+         if (societyOf.ContainsKey(ontology))
+            continue;
+
+         const auto mind = mindOf[ontology];
+         if (not mind->GetSocieties())
+            society->Admit(*mind);
+      }
+   }
+
+   for (auto& society : mSocieties)
+      society.Promote();
+}
+
+/// Configure how minds are gathered into societies                           
+///   @param threshold - minimum estimated similarity of the vocabulary of    
+///      minds in the same society, in the range [0; 1]                       
+///   @param minimum - minimum number of minds to form a society              
+///   @param interval - number of updates between gatherings, zero never      
+///      gathers minds automatically                                          
+void AI::SetKinship(Real threshold, Count minimum, Count interval) {
+   mKinThreshold = threshold;
+   mKinMinimum = minimum;
+   mKinInterval = interval;
+}
+
+/// Poll the metrics of the module - counters and histograms are summed over  
+/// all threads, and history sizes over all minds. Call it on the frame       
+/// thread, while minds aren't updating                                       
+///   @return the metrics, empty if the module was built without them         
+auto AI::GetMetrics() const -> Metrics::Snapshot {
+   Metrics::Snapshot snapshot;
+   Metrics::Collect(snapshot);
+   for (auto& mind : mMinds) {
+      const auto& history = mind.GetHistory();
+      snapshot.mHistoryEvents += history.GetCount();
+      snapshot.mHistorySummaries += history.GetSummaries().size();
+   }
+   return snapshot;
+}
+
+/// Dump the most recent spans of all threads, in the Chrome trace event      
+/// format, so that they can be inspected in a trace viewer                   
+///   @param path - the file to write to                                      
+///   @return true if the file was written, false if it couldn't be, or if    
+///      the module was built without LANGULUS_MOD_AI_TRACE                   
+bool AI::DumpTrace(const Text& path) const {
+   return Trace::Dump(path);
+}
+
+/// Change the number of threads minds are updated on                         
+///   @param count - number of threads, including the calling one; zero or    
+///                  one updates all minds on the calling thread              
+void AI::SetThreadCount(Count count) {
+   mWorkers.SetThreadCount(count);
+}
+
+/// Execute a job in the background, off the frame thread                     
+///   @param job - the job to execute                                         
+void AI::Submit(::std::function<void()>&& job) {
+   mBackground.Submit(::std::move(job));
+}
+
 /// Create/Destroy minds and societies                                        
 ///   @param verb - the creation/destruction verb                             
 void AI::Create(Verb& verb) {
@@ -8,6 +8,8 @@
 #pragma once
 #include "Society.hpp"
 #include "Mind.hpp"
+#include "inner/Workers.hpp"
+#include "inner/Kinship.hpp"
 #include <Langulus/Verbs/Create.hpp>
 
 
@@ -25,10 +27,36 @@ private:
    // List of created societies                                         
    TFactory<Society> mSocieties;
 
+   // Minds are updated in batches of this many. Everything runs on the 
+   // calling thread, unless more threads are requested via             
+   // SetThreadCount                                                    
+   Count mBatchSize = 64;
+   Workers mWorkers;
+   ::std::vector<Mind*> mUpdated;
+
+   // Runs asynchronous interpretations, off the frame thread           
+   Background mBackground;
+
+   // Vocabulary signatures of minds - minds with a lot of knowledge in 
+   // common are periodically gathered into societies                   
+   Kinship mKinship;
+   Real mKinThreshold = 0.5;
+   Count mKinMinimum = 3;
+   Count mKinInterval = 100;
+   Count mSinceGathering = 0;
+
+   void FormSocieties();
+
 public:
    AI(Runtime*, const Many&);
 
    bool Update(Time);
    void Create(Verb&);
    void Teardown();
+
+   void SetThreadCount(Count);
+   void Submit(::std::function<void()>&&);
+   void SetKinship(Real threshold, Count minimum, Count interval);
+   auto GetMetrics() const -> Metrics::Snapshot;
+   bool DumpTrace(const Text&) const;
 };
\ No newline at end of file
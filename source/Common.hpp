@@ -20,7 +20,25 @@ struct AI;
 struct Society;
 struct Mind;
 
-#if 1
+/// Verbose logging formats text on hot paths, so it is opt-in, through the   
+/// LANGULUS_MOD_AI_VERBOSE build option                                      
+#ifndef LANGULUS_MOD_AI_VERBOSE
+   #define LANGULUS_MOD_AI_VERBOSE 0
+#endif
+
+/// Metrics are cheap enough to be on by default, and are opted out of        
+/// through the LANGULUS_MOD_AI_METRICS build option                          
+#ifndef LANGULUS_MOD_AI_METRICS
+   #define LANGULUS_MOD_AI_METRICS 1
+#endif
+
+/// Span tracing times hot paths for a timeline view, and is opt-in through   
+/// the LANGULUS_MOD_AI_TRACE build option                                    
+#ifndef LANGULUS_MOD_AI_TRACE
+   #define LANGULUS_MOD_AI_TRACE 0
+#endif
+
+#if LANGULUS_MOD_AI_VERBOSE
    #define VERBOSE_AI_ENABLED() 1
    #define VERBOSE_AI(...)               Logger::Verbose(Self(), __VA_ARGS__)
    #define VERBOSE_AI_TAB(...)           const auto tab = Logger::VerboseTab(Self(), __VA_ARGS__)
@@ -7,6 +7,8 @@
 ///                                                                           
 #include "Mind.hpp"
 #include "AI.hpp"
+#include <Langulus/Anyness/Bytes.hpp>
+#include <thread>
 
 
 /// Mind construction                                                         
@@ -18,60 +20,323 @@ Mind::Mind(AI* producer, const Many& descriptor)
    , mOntology    {*this} {
    VERBOSE_AI("Initializing...");
    Couple(descriptor);
+
+   // Install any precompiled ontology images                           
+   descriptor.ForEachDeep([&](const Bytes& image) {
+      mOntology.Load(image.GetRaw(), image.GetCount());
+   });
+   mOntology.Publish();
    VERBOSE_AI("Initialized");
 }
 
+/// Get the mind's private ontology                                           
+///   @return the ontology                                                    
+auto Mind::GetOntology() noexcept -> Ontology& {
+   return mOntology;
+}
+
+/// Get the mind's private ontology                                           
+///   @return the ontology                                                    
+auto Mind::GetOntology() const noexcept -> const Ontology& {
+   return mOntology;
+}
+
+/// Get the societies the mind is part of                                     
+///   @return the societies                                                   
+auto Mind::GetSocieties() const noexcept -> const TMany<Society*>& {
+   return mSocieties;
+}
+
+/// Become part of a society - ideas the society shares are no longer         
+/// learned privately, only what the mind learns on top of them is            
+/// Background interpretations keep the version of the ontology they began    
+/// with, so they don't see the society's ideas until they're done            
+///   @param society - the society that admitted the mind                     
+void Mind::Join(Society& society) {
+   mSocieties <<= &society;
+   const auto writer = mOntology.Write();
+   mOntology.Share(society.GetOntology());
+}
+
+/// Stop being part of a society                                              
+///   @param society - the society that dismissed the mind                    
+void Mind::Leave(Society& society) {
+   // Keep what is remembered of the shared history privately. Events   
+   // of the current frame are recorded privately on the next update    
+   if (mSocieties[0] == &society)
+      mWitnessed.Clear();
+   mHistory.Detach(society.GetHistory());
+
+   // Background interpretations might be walking the shared ontology,  
+   // which is destroyed once every member left                         
+   WaitForThoughts();
+   mSocieties.Remove(&society);
+   const auto writer = mOntology.Write();
+   mOntology.Unshare(society.GetOntology());
+}
+
+/// Wait for all background interpretations to complete                       
+void Mind::WaitForThoughts() {
+   for (auto& thought : mAsync) {
+      while (not thought->IsDone())
+         ::std::this_thread::yield();
+   }
+   mAsync.clear();
+}
+
+/// Get the events the mind has witnessed                                     
+///   @return the history                                                     
+auto Mind::GetHistory() const noexcept -> const History& {
+   return mHistory;
+}
+
+/// Change how much of its history the mind remembers verbatim                
+///   @param budget - the new history budget                                  
+void Mind::SetHistoryBudget(const History::Budget& budget) {
+   mHistory.SetBudget(budget);
+}
+
+/// Write old history to disk instead of forgetting it, so that it can be     
+/// replayed later without keeping it in memory                               
+///   @param folder - the folder to keep the history segments in              
+///   @return true if the folder is usable                                    
+bool Mind::SpillHistory(const Text& folder) {
+   return mHistory.Spill(folder);
+}
+
+/// Change which events the mind is able to sense                             
+///   @param perception - the new perception filter                           
+void Mind::SetPerception(const Perception& perception) {
+   mPerception = perception;
+}
+
 /// First stage destruction                                                   
 void Mind::Teardown() {
-   mSocieties.Reset();
+   while (mSocieties)
+      mSocieties.Last()->Dismiss(*this);
+   mFrame.Reset();
+   mWitnessed.Reset();
+   mThoughts.clear();
+   mFlows.Reset();
+
+   // Background interpretations refer to this mind, so wait for them   
+   WaitForThoughts();
    mHistory.Reset();
    mOntology.Teardown();
 }
 
-/// A mind records everything that happens around it                          
+/// A mind records everything it perceives around it                          
 /// This happens through a dispatching Do verb                                
 ///   @param verb - the verb to log and dispatch                              
 void Mind::Do(Verb& verb) {
-   //TODO some verbs require sensing organs to register, filter those here
-   // Record history                                                    
-   if (not mHistory.ContainsKey(mLifetime))
-      mHistory.Insert(mLifetime);
-   mHistory[mLifetime] << verb;
+   AI_TRACE("Mind::Do");
+
+   // Interpreting a mind as bytes gives an image of its ontology - it's
+   // how the ontology compiler gets its output, and isn't an event     
+   if (verb.template IsVerb<Verbs::Interpret>()) {
+      bool introspected = false;
+      verb.ForEachDeep([&](DMeta type) {
+         if (type == MetaDataOf<Bytes>()) {
+            const auto view = mOntology.Read();
+            verb << mOntology.Save();
+            introspected = true;
+         }
+      });
+
+      if (introspected)
+         return;
+   }
+
+   // Some verbs require sensing organs to register                     
+   if (not mPerception.Perceives(verb))
+      return;
+
+   // Record history - the verb is referenced, not cloned, so this is   
+   // cheap. Members of a society hold the event back for the society   
+   // to chronicle, and record it on the next update instead            
+   if (mSocieties)
+      mFrame << verb;
+   else
+      mHistory.Push(mLifetime, verb);
 
    // Dispatch                                                          
    if (verb.template IsVerb<Verbs::Create>()
    or (verb.template IsVerb<Verbs::Select>() and verb.GetMass() > 0)) {
       // For minds, 'select' is isomorphic to 'create' when positive    
+      const auto writer = mOntology.Write();
       mOntology.Create(verb);
    }
 }
 
+/// Learn from another mind - the ideas and everything connected to them, up  
+/// to a budget, are transferred to this mind's ontology in a single batch    
+///   @param teacher - the mind to learn from, can be updated concurrently    
+///   @param about - the ideas to learn about, produced by the teacher        
+///   @param budget - maximum number of ideas to learn                        
+///   @return this mind's counterparts of the ideas, in the same order        
+auto Mind::Learn(const Mind& teacher, const Ideas& about, Count budget) -> Ideas {
+   const auto writer = mOntology.Write();
+   return mOntology.Transfer(teacher.GetOntology(), about, budget);
+}
+
 /// Interpret text                                                            
 ///   @param the message to interpret                                         
 ///   @return the interpreted message                                         
 Many Mind::Interpret(const Text& text) {
+   const Metrics::Timer timer {Metrics::InterpretLatency};
    Text cloned = Clone(text);
 
    // Find combinations of ideas                                        
    auto interpretations = mOntology.Interpret(cloned);
-   const auto tab = Logger::VerboseTab(Self(), Logger::Green,
-      "Interpreted `", cloned, "` into: ");
-   Logger::Verbose("");
-   DumpPatterns(interpretations);
+   #if VERBOSE_AI_ENABLED()
+      const auto tab = Logger::VerboseTab(Self(), Logger::Green,
+         "Interpreted `", cloned, "` into: ");
+      Logger::Verbose("");
+      DumpPatterns(interpretations);
+   #endif
 
    // Convert those ideas into actions                                  
    return Compile(interpretations);
 }
 
+/// Interpret text straight into a flat program, without building the nested  
+/// flow in between, so that it can be run as soon as it is interpreted       
+///   @param text - the message to interpret                                  
+///   @param program - [out] the interpreted message, cleared beforehand      
+void Mind::Interpret(const Text& text, Program& program) {
+   const Metrics::Timer timer {Metrics::InterpretLatency};
+   Text cloned = Clone(text);
+   Compile(mOntology.Interpret(cloned), program);
+}
+
+/// Interpret text gradually, without blocking the caller                     
+/// The interpretation is advanced on each update, within the thinking budget 
+///   @param text - the message to interpret                                  
+///   @return a handle to poll for the interpreted message                    
+auto Mind::InterpretLater(const Text& text) -> ::std::shared_ptr<const Thought> {
+   auto thought = ::std::make_shared<Thought>(text);
+   mThoughts.emplace_back(thought);
+   return thought;
+}
+
+/// Interpret text on a background thread, without blocking the caller        
+/// The background thread reads a consistent version of the ontology, and     
+/// doesn't see, nor block, anything learned meanwhile. Paged ontologies      
+/// fault ideas in while interpreting, so they are interpreted gradually on   
+/// this thread instead                                                       
+///   @param text - the message to interpret                                  
+///   @return a handle to poll for the interpreted message                    
+auto Mind::InterpretAsync(const Text& text) -> ::std::shared_ptr<const Thought> {
+   if (mOntology.IsPaged())
+      return InterpretLater(text);
+
+   auto thought = ::std::make_shared<Thought>(text);
+   mAsync.emplace_back(thought);
+   GetProducer()->Submit([this, thought] {
+      const auto view = mOntology.Read();
+      thought->mResult = Compile(mOntology.Interpret(thought->mText));
+      thought->mStage = Thought::Stage::Done;
+   });
+   return thought;
+}
+
+/// Change how long the mind is allowed to think on each update               
+///   @param budget - the time budget per update                              
+void Mind::SetThinkingBudget(::std::chrono::microseconds budget) {
+   mThinkingBudget = budget;
+}
+
+/// Advance an interpretation in short steps, until it completes, or until    
+/// the deadline passes. At least one step is always made, and no step is     
+/// longer than interpreting a single prefix, so the deadline is overrun by   
+/// a single step at most                                                     
+///   @param thought - the interpretation to advance                          
+///   @param deadline - when to stop thinking                                 
+///   @return true if the interpretation has completed                        
+bool Mind::Think(Thought& thought, ::std::chrono::steady_clock::time_point deadline) {
+   switch (thought.mStage) {
+   case Thought::Stage::Interpreting:
+      do {
+         if (mOntology.Advance(thought.mInterpretation)) {
+            thought.mResult = Abandon(thought.mInterpretation.GetResult());
+            thought.mStage = Thought::Stage::Compiling;
+            break;
+         }
+      }
+      while (::std::chrono::steady_clock::now() < deadline);
+
+      if (thought.mStage != Thought::Stage::Compiling
+      or ::std::chrono::steady_clock::now() >= deadline)
+         return false;
+      [[fallthrough]];
+
+   case Thought::Stage::Compiling:
+      thought.mResult = Compile(thought.mResult);
+      thought.mStage = Thought::Stage::Done;
+      return true;
+
+   default:
+      return true;
+   }
+}
+
 /// Mind update routine                                                       
 ///   @param deltaTime - time between updates                                 
 ///   @return false                                                           
 bool Mind::Update(Time deltaTime) {
+   // Record everything witnessed since the last update, in order -     
+   // events the society recorded are only referenced                   
+   const Society* society = mWitnessed ? mSocieties[0] : nullptr;
+   for (Offset i = 0; i < mFrame.GetCount(); ++i) {
+      const auto shared = society and i < mWitnessed.GetCount()
+         ? society->Recorded(mWitnessed[i]) : nullptr;
+      if (shared)
+         mHistory.Reference(mLifetime, society->GetHistory(), *shared);
+      else
+         mHistory.Push(mLifetime, ::std::move(mFrame[i]));
+   }
+   mFrame.Clear();
+   mWitnessed.Clear();
+
+   // Think about pending interpretations, but only as long as the      
+   // budget allows - whatever remains continues on the next update     
+   const auto deadline = ::std::chrono::steady_clock::now() + mThinkingBudget;
+   while (not mThoughts.empty()) {
+      if (not Think(*mThoughts.front(), deadline))
+         break;
+
+      mThoughts.pop_front();
+      if (::std::chrono::steady_clock::now() >= deadline)
+         break;
+   }
+
    //TODO don't increment time if passed out
    mLifetime += deltaTime;
+   // Forget about completed background interpretations                 
+   ::std::erase_if(mAsync, [](const auto& thought) {
+      return thought->IsDone();
+   });
+
+   {
+      const auto writer = mOntology.Write();
+      mOntology.Update();
+   }
    return false;
 }
 
+/// Tally the events of the current frame in the society the mind is part     
+/// of, so that events witnessed by many members are stored only once, while  
+/// events only this mind witnessed stay private. Must be called before the   
+/// society records the frame, and never concurrently with other members      
+void Mind::Chronicle() {
+   if (not mSocieties or not mFrame)
+      return;
+
+   auto society = mSocieties[0];
+   for (auto& verb : mFrame)
+      mWitnessed << society->Witness(*this, verb);
+}
+
 /// Log the contents of a pattern in a pretty way                             
 ///   @param data - the pattern to log                                        
 void Mind::DumpPatterns(const Many& data) {
@@ -83,7 +348,7 @@ void Mind::DumpPatterns(const Many& data) {
          data.ForEach([&](const Many& group) {
             if (not first)
                Logger::Verbose(Logger::PushDarkYellow, "or ", Logger::Pop);
-            else 
+            else
                Logger::Verbose("|  ");
             Logger::Append(Logger::Tab);
             DumpPatterns(group);
@@ -115,16 +380,88 @@ void Mind::DumpPatterns(const Many& data) {
 }
 
 /// Compile iterpretations into a temporal flow                               
+/// Flows are cached by the hierarchy of ideas they were compiled from, for   
+/// as long as the ontology doesn't change                                    
 ///   @param data - the interpretations to convert to actions                 
-///   @param output - [in/out] the resulting flow                             
+///   @return the resulting flow                                              
 Many Mind::Compile(const Many& data) const {
+   AI_TRACE("Mind::Compile");
+   Metrics::Add(Metrics::Compilations);
+   const auto epoch = mOntology.GetCacheEpoch();
+   Many scope;
+   if (mFlows.Find(data, epoch, scope)) {
+      Metrics::Add(Metrics::CompileCacheHits);
+      return Clone(scope);
+   }
+
+   // Flows are executed, and executing them changes them - the cached  
+   // flow is never handed out, only clones of it                       
+   scope = CompileInner(data);
+   mFlows.Insert(data, scope, epoch);
+   return Clone(scope);
+}
+
+/// Compile interpretations into a flat program, that can be run without      
+/// walking any hierarchy. Equivalent to the nested flow, and built in a      
+/// single pass - reusing the same program avoids allocating                  
+///   @param data - the interpretations to convert to actions                 
+///   @param program - [out] the program, cleared before compiling            
+void Mind::Compile(const Many& data, Program& program) const {
+   AI_TRACE("Mind::Compile");
+   program.Clear();
+   CompileInner(data, program);
+}
+
+/// Emit the instructions for interpretations into a program                  
+///   @param data - the interpretations to convert to actions                 
+///   @param program - [in/out] the program to append to                      
+void Mind::CompileInner(const Many& data, Program& program) const {
+   const bool fork = data.IsOr() and data.GetCount() > 1;
+   if (data.IsDeep()) {
+      if (fork)
+         program.BeginFork();
+      data.ForEach([&](const Many& group) {
+         if (fork)
+            program.BeginBranch();
+         CompileInner(group, program);
+      });
+      if (fork)
+         program.EndFork();
+      return;
+   }
+
+   if (not data.IsSimilar<Idea*>()) {
+      program.Emit(data);
+      return;
+   }
+
+   // Emit verbs extracted from ideas, or the ideas themselves if they  
+   // have no verbs                                                     
+   auto& ideas = reinterpret_cast<const TMany<const Idea*>&>(data);
+   if (fork)
+      program.BeginFork();
+   for (auto idea : ideas) {
+      if (fork)
+         program.BeginBranch();
+      auto verbs = idea->Extract<Verb>();
+      if (verbs)  program.Emit(verbs);
+      else        program.Emit(idea);
+   }
+   if (fork)
+      program.EndFork();
+}
+
+/// Compile iterpretations into a temporal flow, without caching              
+///   @param data - the interpretations to convert to actions                 
+///   @return the resulting flow                                              
+Many Mind::CompileInner(const Many& data) const {
    Many scope;
 
    if (data.IsDeep()) {
       // Nest compilation. No escape from this branch                   
       if (data.IsOr()) {
          data.ForEach([&](const Many& group) {
-            scope <<= Compile(group);
+            scope <<= CompileInner(group);
          });
 
          if (scope.GetCount() > 1)
@@ -132,7 +469,7 @@ Many Mind::Compile(const Many& data) const {
       }
       else {
          data.ForEach([&](const Many& group) {
-            scope << Compile(group);
+            scope << CompileInner(group);
          });
       }
 
@@ -7,10 +7,14 @@
 ///                                                                           
 #pragma once
 #include "inner/Ontology.hpp"
+#include "inner/History.hpp"
+#include "inner/Perception.hpp"
+#include "inner/Thought.hpp"
+#include "inner/Program.hpp"
 #include <Langulus/Verbs/Do.hpp>
-#include <Langulus/Anyness/TMap.hpp>
-
-using History = TOrderedMap<Time, Many>;
+#include <chrono>
+#include <deque>
+#include <memory>
 
 
 ///                                                                           
@@ -40,21 +44,74 @@ private:
    //    something happens periodically or not, which is cheating.      
    // 2. Pushing to a temporal always attempts to execute, and this can 
    //    lead to an infinite regress.                                   
+   // Only the most recent events are kept verbatim, older ones are     
+   // compacted into summaries, so that the history remains bounded     
    History mHistory;
 
+   // Events witnessed during the current frame by a member of a        
+   // society. They are held back until the society chronicles them, so 
+   // they become visible in the history only on the next update. Minds 
+   // outside societies record events as soon as they witness them. The 
+   // buffer is reused between frames                                   
+   TMany<Verb> mFrame;
+
+   // Tallies of the events in the current frame, as chronicled by the  
+   // society. Events other members witnessed as well are stored in the 
+   // history of the society, and only referenced here                  
+   TMany<Offset> mWitnessed;
+
+   // Events the mind is able to sense - all others are neither         
+   // recorded, nor reacted upon                                        
+   Perception mPerception;
+
+   // Interpretations in progress, advanced on each update, but only    
+   // for as long as the thinking budget allows                         
+   ::std::deque<::std::shared_ptr<Thought>> mThoughts;
+   ::std::chrono::microseconds mThinkingBudget {2000};
+
+   // Interpretations running in the background                         
+   ::std::vector<::std::shared_ptr<Thought>> mAsync;
+
+   // Flows compiled from interpretations - repeated commands are       
+   // interpreted to the same ideas, so they compile to the same flow   
+   mutable FlowCache mFlows;
+
    // Societies this mind is part of                                    
    TMany<Society*> mSocieties;
 
+   friend struct Society;
+
    static void DumpPatterns(const Many&);
    Many Compile(const Many&) const;
+   Many CompileInner(const Many&) const;
+   void CompileInner(const Many&, Program&) const;
+   bool Think(Thought&, ::std::chrono::steady_clock::time_point);
+   void WaitForThoughts();
+   void Join(Society&);
+   void Leave(Society&);
 
 public:
    Mind(AI*, const Many&);
 
    void Do(Verb&);
+   void SetHistoryBudget(const History::Budget&);
+   bool SpillHistory(const Text&);
+   void SetPerception(const Perception&);
+   auto Learn(const Mind&, const Ideas&, Count budget = 256) -> Ideas;
 
    Many Interpret(const Text&);
+   void Interpret(const Text&, Program&);
+   void Compile(const Many&, Program&) const;
+   auto InterpretLater(const Text&) -> ::std::shared_ptr<const Thought>;
+   auto InterpretAsync(const Text&) -> ::std::shared_ptr<const Thought>;
+   void SetThinkingBudget(::std::chrono::microseconds);
+   void Chronicle();
    bool Update(Time);
    void Refresh() {};
    void Teardown();
+
+   auto GetOntology() noexcept -> Ontology&;
+   auto GetOntology() const noexcept -> const Ontology&;
+   auto GetHistory() const noexcept -> const History&;
+   auto GetSocieties() const noexcept -> const TMany<Society*>&;
 };
@@ -0,0 +1,15 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "AI.hpp"
+
+LANGULUS_DEFINE_MODULE(
+   AI, 0, "AI",
+   "Artificial intelligence module - "
+   "allows for simulating minds and societies", "",
+   AI, Society, Mind, Idea
+)
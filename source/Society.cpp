@@ -7,6 +7,7 @@
 ///                                                                           
 #include "Society.hpp"
 #include "AI.hpp"
+#include <algorithm>
 
 
 /// Gatherer construction                                                     
@@ -23,10 +24,167 @@ Society::Society(AI* producer, const Many& descriptor)
 
 /// Shutdown the module                                                       
 Society::~Society() {
-
+   // Minds are layered over the shared ontology, so they must leave    
+   // before it is destroyed                                            
+   for (auto mind : mMinds)
+      mind->Leave(*this);
+   mMinds.Reset();
+   mOntology.Teardown();
 }
 
 /// React on environmental change                                             
 void Society::Refresh() {
 
 }
+
+/// Advance the society's time, after all members have been updated           
+///   @param deltaTime - time between updates                                 
+void Society::Update(Time deltaTime) {
+   mWitnessed.clear();
+   mWitnessedOf.Clear();
+   mLifetime += deltaTime;
+}
+
+/// Tally an event witnessed by a member during the current frame             
+///   @attention the event must outlive the frame's Record                    
+///   @param mind - the member that witnessed the event                       
+///   @param verb - the event                                                 
+///   @return the tally of the event, to check if it was recorded             
+auto Society::Witness(const Mind& mind, const Verb& verb) -> Offset {
+   const auto hash = verb.GetHash();
+   const auto found = mWitnessedOf.FindIt(hash);
+   if (found) {
+      auto& tally = mWitnessed[found.GetValue()];
+      if (*tally.mVerb == verb) {
+         if (tally.mLast != &mind) {
+            tally.mLast = &mind;
+            ++tally.mWitnesses;
+         }
+         return found.GetValue();
+      }
+   }
+   else mWitnessedOf.Insert(hash, mWitnessed.size());
+
+   mWitnessed.push_back({&verb, &mind, 1, 0});
+   return mWitnessed.size() - 1;
+}
+
+/// Store the events of the current frame, that more than one member          
+/// witnessed, in the shared history. Events that members still refer to      
+/// are pinned, so that they're never compacted before the members forget     
+/// them, no matter how much the members remember. Must be called after all   
+/// members chronicled their frame, and before they are updated               
+void Society::Record() {
+   auto pinned = mHistory.GetNext();
+   for (auto mind : mMinds)
+      pinned = ::std::min(pinned, mind->GetHistory().GetOldestReference());
+   mHistory.Pin(pinned);
+
+   for (auto& tally : mWitnessed) {
+      if (tally.mWitnesses < 2)
+         continue;
+
+      tally.mSequence = mHistory.GetNext();
+      mHistory.Push(mLifetime, *tally.mVerb);
+   }
+}
+
+/// Check if a tallied event was stored in the shared history                 
+///   @param tally - the tally, as returned by Witness                        
+///   @return the sequence number of the event in the shared history, or      
+///      nullptr if only one member witnessed it, so it is kept privately     
+auto Society::Recorded(Offset tally) const noexcept -> const History::Sequence* {
+   const auto& witnessed = mWitnessed[tally];
+   return witnessed.mWitnesses > 1 ? &witnessed.mSequence : nullptr;
+}
+
+/// Admit a mind into the society, layering its private ontology over the     
+/// shared one, so that everything shared isn't duplicated in each mind       
+///   @param mind - the mind to admit                                         
+void Society::Admit(Mind& mind) {
+   if (mMinds.Contains(&mind))
+      return;
+
+   mMinds <<= &mind;
+   mind.Join(*this);
+
+   // Members refer to shared events for as long as they remember them  
+   // verbatim, so the shared history should remember at least as long. 
+   // Events are pinned while referred to, so this is only a hint on    
+   // how much the ring buffer usually needs                            
+   auto budget = mHistory.GetBudget();
+   const auto& wanted = mind.GetHistory().GetBudget();
+   if (wanted.mRecent > budget.mRecent) {
+      budget.mRecent = wanted.mRecent;
+      mHistory.SetBudget(budget);
+   }
+}
+
+/// Dismiss a mind from the society                                           
+///   @param mind - the mind to dismiss                                       
+void Society::Dismiss(Mind& mind) {
+   if (not mMinds.Remove(&mind))
+      return;
+
+   mind.Leave(*this);
+}
+
+/// Promote the ideas that most members know to the shared ontology, so that  
+/// they're kept once, instead of in each member. Members shadow the shared   
+/// ideas, and forget their private copies, unless they learned something     
+/// on top of them. Minority members inherit the promoted ideas as well       
+///   @attention members must not be updating meanwhile                       
+///   @return the number of ideas promoted                                    
+auto Society::Promote() -> Count {
+   if (mMinds.GetCount() < 2)
+      return 0;
+
+   ::std::vector<const Ontology*> members;
+   members.reserve(mMinds.GetCount());
+   for (auto mind : mMinds)
+      members.push_back(&mind->GetOntology());
+
+   Count promoted;
+   {
+      const auto writer = mOntology.Write();
+      promoted = mOntology.Adopt(members, mMinds.GetCount() / 2 + 1);
+   }
+
+   // Members learn new ideas between promotions, that might shadow     
+   // ideas promoted earlier, so they're pruned even if nothing new was 
+   // promoted this time                                                
+   Count pruned = 0;
+   for (auto mind : mMinds) {
+      auto& ontology = mind->GetOntology();
+      const auto writer = ontology.Write();
+      ontology.Share(mOntology);
+      pruned += ontology.Prune();
+   }
+
+   VERBOSE_AI("Promoted ", promoted, " ideas, members forgot ", pruned, " copies");
+   return promoted;
+}
+
+/// Get the shared ontology                                                   
+///   @return the ontology                                                    
+auto Society::GetOntology() noexcept -> Ontology& {
+   return mOntology;
+}
+
+/// Get the shared ontology                                                   
+///   @return the ontology                                                    
+auto Society::GetOntology() const noexcept -> const Ontology& {
+   return mOntology;
+}
+
+/// Get the shared history                                                    
+///   @return the history                                                     
+auto Society::GetHistory() const noexcept -> const History& {
+   return mHistory;
+}
+
+/// Get the members of the society                                            
+///   @return the minds, in order of admission                                
+auto Society::GetMinds() const noexcept -> const TMany<Mind*>& {
+   return mMinds;
+}
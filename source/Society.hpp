@@ -7,13 +7,16 @@
 ///                                                                           
 #pragma once
 #include "Mind.hpp"
+#include <vector>
 
 
 ///                                                                           
 ///   A society                                                               
 ///                                                                           
 /// Acts as an optimization by storing shared data and manages roles.         
-/// Societies emerge when minds have a lot of shared knowledge.               
+/// Societies emerge when minds have a lot of shared knowledge - ideas most   
+/// members know are promoted to the shared ontology, and members forget      
+/// their private copies, unless they learned something on top of them.       
 /// Roles emerge when minds start specializing and dividing labor.            
 ///                                                                           
 struct Society final : A::AIUnit, ProducedFrom<AI> {
@@ -22,8 +25,24 @@ struct Society final : A::AIUnit, ProducedFrom<AI> {
    LANGULUS_BASES(A::AIUnit);
 
 private:
-   // Shared history                                                    
+   // Shared history - events witnessed by many members are stored here 
+   // once, and members only keep references to them                    
    History mHistory;
+   Time mLifetime;
+
+   // An event witnessed during the current frame, and by how many      
+   // members. The event itself stays in the frame of the first witness 
+   struct Witnessed {
+      const Verb* mVerb;
+      const Mind* mLast;
+      Count mWitnesses;
+      History::Sequence mSequence;
+   };
+
+   // Events witnessed during the current frame, and where to find them 
+   // by hash. Colliding events aren't indexed, and are never shared    
+   ::std::vector<Witnessed> mWitnessed;
+   TUnorderedMap<Hash, Offset> mWitnessedOf;
    // Shared ontology                                                   
    Ontology mOntology;
    // Participating minds                                               
@@ -34,4 +53,17 @@ public:
    ~Society();
 
    void Refresh();
+   void Update(Time);
+
+   void Admit(Mind&);
+   void Dismiss(Mind&);
+   auto Promote() -> Count;
+   auto Witness(const Mind&, const Verb&) -> Offset;
+   void Record();
+   auto Recorded(Offset) const noexcept -> const History::Sequence*;
+
+   auto GetOntology() noexcept -> Ontology&;
+   auto GetOntology() const noexcept -> const Ontology&;
+   auto GetHistory() const noexcept -> const History&;
+   auto GetMinds() const noexcept -> const TMany<Mind*>&;
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Cache.hpp"
+
+
+/// Pick the shard a key belongs to                                           
+///   @param key - the key                                                    
+///   @return the shard                                                       
+template<class K>
+auto TCache<K>::ShardOf(const K& key) const -> Shard& {
+   return mShards[key.GetHash().mHash % ShardCount];
+}
+
+/// Look up a result                                                          
+///   @param key - the key to look up                                         
+///   @param epoch - the epoch of the ontology the result is needed for       
+///   @param result - [out] the cached result, if found                       
+///   @return true if the key was found                                       
+template<class K>
+bool TCache<K>::Find(const K& key, Epoch epoch, Many& result) const {
+   auto& shard = ShardOf(key);
+   const ::std::lock_guard lock {shard.mMutex};
+   if (shard.mEpoch != epoch)
+      return false;
+
+   const auto found = shard.mMap.FindIt(key);
+   if (not found)
+      return false;
+
+   result = found.GetValue();
+   return true;
+}
+
+/// Cache a result                                                            
+///   @param key - the key                                                    
+///   @param result - the result                                              
+///   @param epoch - the epoch of the ontology the result was produced in     
+template<class K>
+void TCache<K>::Insert(const K& key, const Many& result, Epoch epoch) const {
+   auto& shard = ShardOf(key);
+   const ::std::lock_guard lock {shard.mMutex};
+   if (epoch < shard.mEpoch)
+      return;
+
+   if (epoch > shard.mEpoch) {
+      // Results from older epochs might miss new ideas and links       
+      shard.mMap.Clear();
+      shard.mEpoch = epoch;
+   }
+   shard.mMap.Insert(key, result);
+}
+
+/// Forget all results, but keep the memory for reuse                         
+template<class K>
+void TCache<K>::Clear() const {
+   for (auto& shard : mShards) {
+      const ::std::lock_guard lock {shard.mMutex};
+      shard.mMap.Clear();
+   }
+}
+
+/// Forget all results and release the memory                                 
+template<class K>
+void TCache<K>::Reset() const {
+   for (auto& shard : mShards) {
+      const ::std::lock_guard lock {shard.mMutex};
+      shard.mMap.Reset();
+   }
+}
+
+template struct TCache<Text>;
+template struct TCache<Many>;
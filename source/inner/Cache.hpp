@@ -0,0 +1,49 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Links.hpp"
+#include <Langulus/Anyness/TMap.hpp>
+#include <array>
+#include <mutex>
+
+
+///                                                                           
+///   Sharded cache                                                           
+///                                                                           
+/// Maps keys to results that are valid only for a single epoch of an         
+/// ontology - text to its interpretation, or an interpretation to the flow   
+/// it compiles to. The cache is split into shards by the hash of the key,    
+/// each with its own lock, so that many threads can use the same ontology    
+/// at once, and rarely wait on each other.                                   
+///                                                                           
+template<class K>
+struct TCache {
+   static constexpr Count ShardCount = 16;
+
+private:
+   struct alignas(64) Shard {
+      ::std::mutex mMutex;
+      Epoch mEpoch = 0;
+      TUnorderedMap<K, Many> mMap;
+   };
+
+   mutable ::std::array<Shard, ShardCount> mShards;
+
+   auto ShardOf(const K&) const -> Shard&;
+
+public:
+   bool Find(const K&, Epoch, Many&) const;
+   void Insert(const K&, const Many&, Epoch) const;
+   void Clear() const;
+   void Reset() const;
+};
+
+/// Interpretations of text                                                   
+using Cache = TCache<Text>;
+/// Flows compiled from interpretations, keyed by the hierarchy of ideas      
+using FlowCache = TCache<Many>;
@@ -0,0 +1,868 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "History.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+
+/// Check if an equal verb is already kept as a sample                        
+///   @param verb - the verb to search for                                    
+///   @return true if an equal verb is kept                                   
+bool History::Summary::Contains(const Verb& verb) const {
+   if (not mHashes.Contains(verb.GetHash()))
+      return false;
+
+   for (auto& sample : mDistinct) {
+      if (sample == verb)
+         return true;
+   }
+   return false;
+}
+
+/// Keep a verb as a sample                                                   
+///   @attention assumes no equal verb is kept already                        
+///   @param verb - the verb to keep                                          
+void History::Summary::Keep(Verb&& verb) {
+   mHashes << verb.GetHash();
+   mDistinct << ::std::move(verb);
+}
+
+/// Merge a newer summary into this one                                       
+///   @param other - the summary to merge, must be newer than this one        
+///   @param limit - the maximum number of samples to keep                    
+void History::Summary::Merge(Summary&& other, Count limit) {
+   if (not mEvents)
+      mFrom = other.mFrom;
+   mTo = other.mTo;
+   mEvents += other.mEvents;
+
+   for (auto pair : other.mCounts) {
+      if (mCounts.ContainsKey(pair.mKey))
+         mCounts[pair.mKey] += pair.mValue;
+      else
+         mCounts.Insert(pair.mKey, pair.mValue);
+   }
+
+   for (auto& verb : other.mDistinct) {
+      if (mDistinct.GetCount() >= limit)
+         break;
+      if (not Contains(verb))
+         Keep(::std::move(verb));
+   }
+}
+
+/// Create a history with a custom budget                                     
+///   @param budget - the memory budget                                       
+History::History(const Budget& budget) {
+   SetBudget(budget);
+}
+
+/// Change the memory budget of the history                                   
+/// Events that no longer fit are compacted immediately                       
+///   @param budget - the new memory budget                                   
+void History::SetBudget(const Budget& budget) {
+   mBudget = budget;
+   mBudget.mRecent = ::std::max<Count>(mBudget.mRecent, 1);
+   mBudget.mWindow = ::std::clamp<Count>(mBudget.mWindow, 1, mBudget.mRecent);
+   mBudget.mSummaries = ::std::max<Count>(mBudget.mSummaries, 1);
+   Rebuild(false);
+}
+
+/// Rebuild the ring buffer, after its budget or its store have changed       
+///   @param localize - whether to copy shared events from the store and      
+///      keep them privately from now on                                      
+void History::Rebuild(bool localize) {
+   // Unroll the ring in order                                          
+   ::std::vector<Time> times;
+   ::std::vector<VMeta> types;
+   ::std::vector<Hash> arguments;
+   ::std::vector<Sequence> entries;
+   times.reserve(mCount);
+   types.reserve(mCount);
+   arguments.reserve(mCount);
+   entries.reserve(mCount);
+   for (Offset i = 0; i < mCount; ++i) {
+      const auto s = Slot(i);
+      times.emplace_back(mTimes[s]);
+      types.emplace_back(mTypes[s]);
+      arguments.emplace_back(mArguments[s]);
+      entries.emplace_back(mEntries[s]);
+   }
+
+   ::std::deque<Verb> localized;
+   if (localize) {
+      for (auto entry : entries) {
+         if (entry & Shared) {
+            const auto verb = Resolve(entry);
+            localized.emplace_back(verb ? Verb {*verb} : Verb {});
+         }
+      }
+      mStore = nullptr;
+   }
+
+   // Replay the unrolled events, keeping their sequence numbers        
+   auto privates = ::std::move(mPrivate);
+   const auto first = mFirst;
+   mTimes.clear();
+   mTypes.clear();
+   mArguments.clear();
+   mEntries.clear();
+   mPrivate.clear();
+   mPrivateFirst = 0;
+   mReferences.clear();
+   mIndices.clear();
+   mIndexOf.Reset();
+   mLastType = {};
+   mHead = mCount = 0;
+   mFirst = first;
+   for (Offset i = 0; i < times.size(); ++i) {
+      if (not (entries[i] & Shared)) {
+         PushPrivate(times[i], types[i], ::std::move(privates.front()));
+         privates.pop_front();
+      }
+      else if (localize) {
+         PushPrivate(times[i], types[i], ::std::move(localized.front()));
+         localized.pop_front();
+      }
+      else Append(times[i], types[i], arguments[i], entries[i]);
+   }
+}
+
+/// Get the memory budget of the history                                      
+///   @return the budget                                                      
+auto History::GetBudget() const noexcept -> const Budget& {
+   return mBudget;
+}
+
+/// Map a recent event index to its slot in the ring buffer                   
+///   @param index - the event index, zero being the oldest recent event      
+///   @return the slot                                                        
+auto History::Slot(Offset index) const noexcept -> Offset {
+   return (mHead + index) % mTimes.size();
+}
+
+/// Find the verb an entry refers to                                          
+///   @param entry - the entry                                                
+///   @return the verb, or nullptr if the store has already forgotten it      
+auto History::Resolve(Sequence entry) const noexcept -> const Verb* {
+   if (entry & Shared)
+      return mStore ? mStore->Find(entry & ~Shared) : nullptr;
+   return &mPrivate[static_cast<Offset>(entry - mPrivateFirst)];
+}
+
+/// Get the verb of the event in a slot of the ring buffer                    
+///   @param slot - the slot                                                  
+///   @return the verb, or an empty verb, if it was shared and forgotten      
+auto History::VerbAt(Offset slot) const noexcept -> const Verb& {
+   static const Verb Forgotten {};
+   const auto verb = Resolve(mEntries[slot]);
+   return verb ? *verb : Forgotten;
+}
+
+/// Get the index of a verb type, creating it if missing                      
+///   @param type - the verb type                                             
+///   @return the sequence numbers of the recent events of that type          
+auto History::IndexOf(VMeta type) -> ::std::deque<Sequence>& {
+   if (type == mLastType and not mIndices.empty())
+      return mIndices[mLastIndex];
+
+   const auto found = mIndexOf.FindIt(type);
+   if (found)
+      mLastIndex = found.GetValue();
+   else {
+      mLastIndex = mIndices.size();
+      mIndices.emplace_back();
+      mIndexOf.Insert(type, mLastIndex);
+   }
+
+   mLastType = type;
+   return mIndices[mLastIndex];
+}
+
+/// Find the index of a verb type                                             
+///   @param type - the verb type                                             
+///   @return the sequence numbers of the recent events of that type, or      
+///           nullptr if the type never happened recently                     
+auto History::FindIndex(VMeta type) const -> const ::std::deque<Sequence>* {
+   if (type == mLastType and not mIndices.empty())
+      return &mIndices[mLastIndex];
+
+   const auto found = mIndexOf.FindIt(type);
+   return found ? &mIndices[found.GetValue()] : nullptr;
+}
+
+/// Record an event                                                           
+///   @attention events must be pushed in time order                          
+///   @param time - the time at which the event happened                      
+///   @param verb - the event, referenced, not cloned                         
+void History::Push(Time time, const Verb& verb) {
+   Push(time, Verb {verb});
+}
+
+/// Record an event                                                           
+/// If the ring buffer is full, its oldest window is compacted first          
+///   @attention events must be pushed in time order                          
+///   @param time - the time at which the event happened                      
+///   @param verb - the event to move in                                      
+void History::Push(Time time, Verb&& verb) {
+   const auto type = verb.GetVerb();
+   PushPrivate(time, type, ::std::move(verb));
+}
+
+/// Record a private event                                                    
+///   @param time - the time at which the event happened                      
+///   @param type - the verb type                                             
+///   @param verb - the event to move in                                      
+void History::PushPrivate(Time time, VMeta type, Verb&& verb) {
+   // Compacting only ever removes verbs from the front, so the private 
+   // sequence number of the next verb doesn't change                   
+   const auto entry = mPrivateFirst + mPrivate.size();
+   const auto argument = verb.GetArgument().GetHash();
+   mPrivate.emplace_back(::std::move(verb));
+   Append(time, type, argument, entry);
+}
+
+/// Append an entry to the ring buffer                                        
+/// If the ring buffer is full, its oldest window is compacted first, unless  
+/// it is pinned, in which case the ring buffer grows instead                 
+///   @param time - the time at which the event happened                      
+///   @param type - the verb type                                             
+///   @param argument - the hash of the verb's argument                       
+///   @param entry - the entry                                                
+void History::Append(Time time, VMeta type, Hash argument, Sequence entry) {
+   if (mTimes.size() < mBudget.mRecent) {
+      mTimes.resize(mBudget.mRecent);
+      mTypes.resize(mBudget.mRecent);
+      mArguments.resize(mBudget.mRecent);
+      mEntries.resize(mBudget.mRecent);
+   }
+
+   if (mCount >= mBudget.mRecent and mFirst < mPinned)
+      CompactOldest();
+   if (mCount == mTimes.size())
+      Grow();
+
+   const auto s = Slot(mCount);
+   mTimes[s] = time;
+   mTypes[s] = type;
+   mArguments[s] = argument;
+   mEntries[s] = entry;
+   IndexOf(type).push_back(mFirst + mCount);
+   if (entry & Shared)
+      mReferences.push_back(mFirst + mCount);
+   ++mCount;
+}
+
+/// Double the ring buffer, when it is full of pinned events - the events     
+/// are rotated in order first, so that the new slots follow the newest one   
+void History::Grow() {
+   const auto size = ::std::max<Count>(mTimes.size() * 2, 1);
+   ::std::rotate(mTimes.begin(), mTimes.begin() + mHead, mTimes.end());
+   ::std::rotate(mTypes.begin(), mTypes.begin() + mHead, mTypes.end());
+   ::std::rotate(mArguments.begin(), mArguments.begin() + mHead, mArguments.end());
+   ::std::rotate(mEntries.begin(), mEntries.begin() + mHead, mEntries.end());
+   mHead = 0;
+   mTimes.resize(size);
+   mTypes.resize(size);
+   mArguments.resize(size);
+   mEntries.resize(size);
+}
+
+/// Record a batch of events that happened at the same time                   
+///   @attention events must be pushed in time order                          
+///   @param time - the time at which the events happened                     
+///   @param batch - [in/out] the events to move in; the batch is cleared,    
+///                  but keeps its capacity, so that it can be reused         
+void History::Push(Time time, TMany<Verb>& batch) {
+   for (auto& verb : batch)
+      Push(time, ::std::move(verb));
+   batch.Clear();
+}
+
+/// Record an event that is kept in a store shared with other histories       
+/// Only its time, type and sequence number are kept here                     
+///   @attention events must be pushed in time order, and a history can       
+///      have only one store at a time - changing it detaches the old one     
+///   @param time - the time at which the event happened                      
+///   @param store - the history that stores the event                        
+///   @param sequence - the sequence number of the event in the store         
+void History::Reference(Time time, const History& store, Sequence sequence) {
+   const auto verb = store.Find(sequence);
+   if (not verb)
+      return;
+
+   if (mStore != &store) {
+      if (mStore)
+         Rebuild(true);
+      mStore = &store;
+   }
+
+   Append(time, verb->GetVerb(), verb->GetArgument().GetHash(), sequence | Shared);
+}
+
+/// Record a batch of shared events that happened at the same time            
+///   @param time - the time at which the events happened                     
+///   @param store - the history that stores the events                       
+///   @param batch - [in/out] sequence numbers of the events in the store;    
+///      the batch is cleared, but keeps its capacity                         
+void History::Reference(Time time, const History& store, TMany<Sequence>& batch) {
+   for (auto sequence : batch)
+      Reference(time, store, sequence);
+   batch.Clear();
+}
+
+/// Stop referencing a store - shared events that it still remembers are      
+/// copied and kept privately from now on                                     
+///   @param store - the store to detach from                                 
+void History::Detach(const History& store) {
+   if (mStore == &store)
+      Rebuild(true);
+}
+
+/// Keep events verbatim from a sequence number on, even past the budget -    
+/// a store pins the events other histories still refer to. Pinning a later   
+/// sequence number releases the earlier events, and they're compacted as     
+/// soon as the next event is pushed                                          
+///   @param sequence - the oldest event to keep                              
+void History::Pin(Sequence sequence) {
+   mPinned = sequence;
+}
+
+/// Compact the oldest window of recent events into a summary                 
+void History::CompactOldest() {
+   Summary summary;
+   const auto window = static_cast<Count>(::std::min<Sequence>(
+      ::std::min(mBudget.mWindow, mCount), mPinned - mFirst));
+
+   // Spilled verbs can be streamed back from disk, so the summary      
+   // doesn't need to remember them                                     
+   const bool spilled = SpillOldest(window);
+   for (Offset i = 0; i < window; ++i) {
+      const auto type = mTypes[mHead];
+      if (i == 0)
+         summary.mFrom = mTimes[mHead];
+      summary.mTo = mTimes[mHead];
+      ++summary.mEvents;
+
+      if (summary.mCounts.ContainsKey(type))
+         ++summary.mCounts[type];
+      else
+         summary.mCounts.Insert(type, 1);
+
+      // Shared verbs are copied, private ones are moved out            
+      const auto entry = mEntries[mHead];
+      const auto verb = Resolve(entry);
+      if (verb and not spilled
+      and summary.mDistinct.GetCount() < mBudget.mDistinct
+      and not summary.Contains(*verb)) {
+         if (entry & Shared)
+            summary.Keep(Verb {*verb});
+         else
+            summary.Keep(::std::move(mPrivate.front()));
+      }
+
+      if (not (entry & Shared)) {
+         mPrivate.pop_front();
+         ++mPrivateFirst;
+      }
+      else mReferences.pop_front();
+
+      // The oldest event is always at the front of its type index      
+      IndexOf(type).pop_front();
+
+      mHead = (mHead + 1) % mTimes.size();
+      ++mFirst;
+      --mCount;
+   }
+
+   mSummaries.emplace_back(::std::move(summary));
+
+   // Merge the two oldest summaries, if over budget                    
+   if (mSummaries.size() > mBudget.mSummaries) {
+      mSummaries[0].Merge(::std::move(mSummaries[1]), mBudget.mDistinct);
+      mSummaries.erase(mSummaries.begin() + 1);
+   }
+}
+
+/// Forget everything                                                         
+void History::Reset() {
+   mSpiller.Stop();
+   mTimes.clear();
+   mTypes.clear();
+   mArguments.clear();
+   mEntries.clear();
+   mPrivate.clear();
+   mPrivateFirst = 0;
+   mReferences.clear();
+   mPinned = ~Sequence {0};
+   mStore = nullptr;
+   mIndices.clear();
+   mIndexOf.Reset();
+   mLastType = {};
+   mSummaries.clear();
+   mSegments.clear();
+   mSpillFolder.Reset();
+   mSpillOffset = 0;
+   mHead = mCount = 0;
+   mFirst = 0;
+}
+
+/// Get the number of recent events, kept verbatim                            
+///   @return the number of events in the ring buffer                         
+auto History::GetCount() const noexcept -> Count {
+   return mCount;
+}
+
+/// Get the summaries of older events                                         
+///   @return the summaries, oldest first                                     
+auto History::GetSummaries() const noexcept -> const ::std::vector<Summary>& {
+   return mSummaries;
+}
+
+/// Get the time of a recent event                                            
+///   @param index - the event index, zero being the oldest recent event      
+///   @return the time                                                        
+auto History::GetTime(Offset index) const noexcept -> Time {
+   return mTimes[Slot(index)];
+}
+
+/// Get the verb type of a recent event                                       
+///   @param index - the event index, zero being the oldest recent event      
+///   @return the verb type                                                   
+auto History::GetType(Offset index) const noexcept -> VMeta {
+   return mTypes[Slot(index)];
+}
+
+/// Get a recent event                                                        
+///   @param index - the event index, zero being the oldest recent event      
+///   @return the verb                                                        
+auto History::GetVerb(Offset index) const noexcept -> const Verb& {
+   return VerbAt(Slot(index));
+}
+
+/// Get the sequence number the next event will have                          
+///   @return the sequence number                                             
+auto History::GetNext() const noexcept -> Sequence {
+   return mFirst + mCount;
+}
+
+/// Get the oldest event in the store that this history still refers to       
+///   @return the sequence number of the event in the store, or the largest   
+///      sequence number, if no recent event refers to the store              
+auto History::GetOldestReference() const noexcept -> Sequence {
+   if (mReferences.empty())
+      return ~Sequence {0};
+
+   const auto slot = Slot(static_cast<Offset>(mReferences.front() - mFirst));
+   return mEntries[slot] & ~Shared;
+}
+
+/// Find a recent event by its sequence number                                
+///   @param sequence - the sequence number                                   
+///   @return the verb, or nullptr if the event isn't recent anymore          
+auto History::Find(Sequence sequence) const noexcept -> const Verb* {
+   if (sequence < mFirst or sequence >= mFirst + mCount)
+      return nullptr;
+   return Resolve(mEntries[Slot(static_cast<Offset>(sequence - mFirst))]);
+}
+
+/// Find the first recent event that didn't happen before a time              
+///   @param time - the time                                                  
+///   @return the event index, or the number of events if none                
+auto History::LowerBound(Time time) const noexcept -> Offset {
+   Offset lo = 0, hi = mCount;
+   while (lo < hi) {
+      const auto mid = lo + (hi - lo) / 2;
+      if (mTimes[Slot(mid)] < time)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+/// Find the first recent event that happened after a time                    
+///   @param time - the time                                                  
+///   @return the event index, or the number of events if none                
+auto History::UpperBound(Time time) const noexcept -> Offset {
+   Offset lo = 0, hi = mCount;
+   while (lo < hi) {
+      const auto mid = lo + (hi - lo) / 2;
+      if (not (time < mTimes[Slot(mid)]))
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+/// Find the recent events in the time range [from; to]                       
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+///   @return the [begin; end) event indices                                  
+auto History::Range(Time from, Time to) const noexcept
+-> ::std::pair<Offset, Offset> {
+   const auto begin = LowerBound(from);
+   return {begin, ::std::max(begin, UpperBound(to))};
+}
+
+/// Find the recent events of a verb type in the time range [from; to]        
+///   @param type - the verb type                                             
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+///   @return the type index (or nullptr if type never happened recently),    
+///           and the [begin; end) range inside it                            
+auto History::TypeRange(VMeta type, Time from, Time to) const
+-> ::std::pair<const ::std::deque<Sequence>*, ::std::pair<Offset, Offset>> {
+   const auto found = FindIndex(type);
+   if (not found)
+      return {nullptr, {0, 0}};
+
+   const auto& index = *found;
+   const auto timeOf = [&](Sequence seq) {
+      return mTimes[Slot(static_cast<Offset>(seq - mFirst))];
+   };
+   const auto begin = ::std::partition_point(index.begin(), index.end(),
+      [&](Sequence seq) { return timeOf(seq) < from; });
+   const auto end = ::std::partition_point(begin, index.end(),
+      [&](Sequence seq) { return not (to < timeOf(seq)); });
+   return {&index, {
+      static_cast<Offset>(begin - index.begin()),
+      static_cast<Offset>(end - index.begin())
+   }};
+}
+
+/// Count how many times a verb type happened, including compacted events     
+///   @param type - the verb type                                             
+///   @return the number of events of that type                               
+auto History::CountOf(VMeta type) const -> Count {
+   Count result = 0;
+   if (const auto index = FindIndex(type))
+      result += index->size();
+
+   for (auto& summary : mSummaries) {
+      const auto counted = summary.mCounts.FindIt(type);
+      if (counted)
+         result += counted.GetValue();
+   }
+   return result;
+}
+
+/// Count how many times a verb type happened in a time range. Compacted      
+/// events are counted only from summaries that lie entirely in the range,    
+/// because a summary can't tell when inside its window each event was        
+///   @param type - the verb type                                             
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+///   @return the number of events of that type in the range                  
+auto History::CountOf(VMeta type, Time from, Time to) const -> Count {
+   const auto [index, range] = TypeRange(type, from, to);
+   Count result = index ? range.second - range.first : 0;
+
+   for (auto& summary : mSummaries) {
+      if (summary.mFrom < from or to < summary.mTo)
+         continue;
+
+      const auto counted = summary.mCounts.FindIt(type);
+      if (counted)
+         result += counted.GetValue();
+   }
+   return result;
+}
+
+/// Spill compacted windows to disk from now on, instead of only keeping      
+/// their summaries. Segments that were previously spilled to the same        
+/// folder are discovered, so that a persistent history can be continued      
+///   @param folder - the folder to spill segments into                       
+///   @return true if the folder is usable                                    
+bool History::Spill(const Text& folder) {
+   namespace fs = ::std::filesystem;
+   const fs::path root = MappedFile::Path(folder);
+   ::std::error_code error;
+   WaitForSpills();
+   fs::create_directories(root, error);
+   if (error) {
+      Logger::Error("Can't create history folder `", folder, '`');
+      return false;
+   }
+
+   // Discover existing segments                                        
+   ::std::vector<Segment> found;
+   for (const auto& entry : fs::directory_iterator {root, error}) {
+      if (entry.path().extension() != ".hseg")
+         continue;
+
+      const Text path {entry.path().string().c_str()};
+      MappedFile file;
+      if (not file.Open(path) or file.GetSize() < sizeof(HistorySegmentHeader))
+         continue;
+
+      HistorySegmentHeader header;
+      ::std::memcpy(&header, file.GetRaw(), sizeof(header));
+      if (::std::memcmp(header.mMagic, HistorySegmentHeader::Magic, sizeof(header.mMagic))
+      or header.mVersion != HistorySegmentHeader::CurrentVersion
+      or header.mEndianness != HistorySegmentHeader::NativeEndianness) {
+         Logger::Warning("Ignoring incompatible history segment `", path, '`');
+         continue;
+      }
+
+      Segment segment;
+      segment.mPath = path;
+      segment.mFirst = header.mFirst;
+      segment.mEvents = header.mCount;
+      ::std::memcpy(&segment.mFrom, header.mFrom, sizeof(Time));
+      ::std::memcpy(&segment.mTo, header.mTo, sizeof(Time));
+      found.emplace_back(::std::move(segment));
+   }
+
+   ::std::sort(found.begin(), found.end(), [](const Segment& a, const Segment& b) {
+      return a.mFirst < b.mFirst;
+   });
+
+   mSpillFolder = folder;
+   mSegments = ::std::move(found);
+   mSpillOffset = 0;
+
+   // A fresh history continues the sequence of the discovered segments,
+   // while a history that already has events keeps its own sequence    
+   // numbers, and only numbers its segments after the discovered ones  
+   if (not mSegments.empty()) {
+      const auto next = mSegments.back().mFirst + mSegments.back().mEvents;
+      if (not mCount and mSummaries.empty())
+         mFirst = next;
+      else if (mFirst < next)
+         mSpillOffset = next - mFirst;
+   }
+   return true;
+}
+
+/// Encode the oldest window of recent events as a new segment, and write it  
+/// to disk on the background thread. The segment is listed immediately,      
+/// and streams wait for pending writes before they read any segment          
+///   @param window - number of oldest recent events to spill                 
+///   @return true if the events were spilled                                 
+bool History::SpillOldest(Count window) {
+   if (not mSpillFolder or not window)
+      return false;
+
+   Segment segment;
+   segment.mFirst = mFirst + mSpillOffset;
+   segment.mEvents = window;
+   segment.mFrom = mTimes[Slot(0)];
+   segment.mTo = mTimes[Slot(window - 1)];
+
+   char name[32];
+   ::std::snprintf(name, sizeof(name), "%020llu.hseg",
+      static_cast<unsigned long long>(segment.mFirst));
+   const auto native = (::std::filesystem::path {MappedFile::Path(mSpillFolder)} / name).string();
+   segment.mPath = Text {native.c_str()};
+
+   HistorySegmentHeader header {};
+   ::std::memcpy(header.mMagic, HistorySegmentHeader::Magic, sizeof(header.mMagic));
+   header.mVersion = HistorySegmentHeader::CurrentVersion;
+   header.mEndianness = HistorySegmentHeader::NativeEndianness;
+   header.mFirst = segment.mFirst;
+   header.mCount = segment.mEvents;
+   ::std::memcpy(header.mFrom, &segment.mFrom, sizeof(Time));
+   ::std::memcpy(header.mTo, &segment.mTo, sizeof(Time));
+
+   ByteWriter image;
+   image.WritePOD(header);
+
+   static constexpr ::std::uint8_t Padding[8] {};
+   for (Offset i = 0; i < window; ++i) {
+      const auto s = Slot(i);
+      const auto blob = EncodeDescriptor(Many {VerbAt(s)});
+
+      HistoryRecord record {};
+      record.mPayload = blob.GetCount();
+      ::std::memcpy(record.mTime, &mTimes[s], sizeof(Time));
+      image.WritePOD(record);
+      image.Write(blob.GetRaw(), blob.GetCount());
+      image.Write(Padding, AlignSection(blob.GetCount()) - blob.GetCount());
+   }
+
+   // Write into a staging file first, and seal it by renaming it, so   
+   // that a torn segment is never discovered                           
+   mSpiller.Submit([native, image = ::std::move(image)] {
+      const auto staging = native + ".tmp";
+      FileWriter file;
+      const bool ok = file.Open(Text {staging.c_str()})
+         and file.Write(image.GetRaw(), image.GetWritten())
+         and file.Flush();
+      file.Close();
+
+      if (not ok or ::std::rename(staging.c_str(), native.c_str()) != 0) {
+         Logger::Error("Can't spill history to `", native.c_str(), '`');
+         ::std::remove(staging.c_str());
+      }
+   });
+
+   mSegments.emplace_back(::std::move(segment));
+   return true;
+}
+
+/// Wait until all spilled segments are written to disk                       
+void History::WaitForSpills() const {
+   mSpiller.Stop();
+}
+
+/// Get the segments that were spilled to disk                                
+///   @return the segments, oldest first                                      
+auto History::GetSegments() const noexcept -> const ::std::vector<Segment>& {
+   return mSegments;
+}
+
+/// Stream all remembered events in time order                                
+///   @attention the history must not change while streaming                  
+///   @return the stream, call Next() to advance to the first event           
+auto History::Replay() const -> Stream {
+   WaitForSpills();
+   return Stream {this};
+}
+
+/// Stream remembered events in the time range [from; to], in time order,     
+/// optionally only those of a verb type. Spilled segments outside the        
+/// range aren't mapped at all                                                
+///   @attention the history must not change while streaming                  
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+///   @param type - the verb type, or nullptr for events of any type          
+///   @return the stream, call Next() to advance to the first event           
+auto History::Replay(Time from, Time to, VMeta type) const -> Stream {
+   WaitForSpills();
+   return Stream {this, from, to, type};
+}
+
+/// Begin streaming a history                                                 
+///   @param history - the history to stream                                  
+History::Stream::Stream(const History* history)
+   : mHistory {history}
+   , mRecentEnd {history->mCount} {}
+
+/// Begin streaming a part of a history                                       
+///   @param history - the history to stream                                  
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+///   @param type - the verb type, or nullptr for events of any type          
+History::Stream::Stream(const History* history, Time from, Time to, VMeta type)
+   : mHistory {history}
+   , mFrom {from}
+   , mTo {to}
+   , mType {type}
+   , mBounded {true} {
+   // Segments are in time order, so skip those that end too early      
+   const auto& segments = history->mSegments;
+   mSegment = static_cast<Offset>(::std::partition_point(
+      segments.begin(), segments.end(),
+      [&](const Segment& segment) { return segment.mTo < from; }
+   ) - segments.begin());
+
+   const auto range = history->Range(from, to);
+   mRecent = range.first;
+   mRecentEnd = range.second;
+}
+
+/// Map the current segment, skipping segments that can't be read             
+///   @return true if a segment was mapped                                    
+bool History::Stream::OpenSegment() {
+   while (mSegment < mHistory->mSegments.size()) {
+      const auto& segment = mHistory->mSegments[mSegment];
+      if (mFile.Open(segment.mPath) and mFile.GetSize() >= sizeof(HistorySegmentHeader)) {
+         mCursor = sizeof(HistorySegmentHeader);
+         mLeft = segment.mEvents;
+         return true;
+      }
+
+      Logger::Warning("Skipping unreadable history segment `", segment.mPath, '`');
+      ++mSegment;
+   }
+   return false;
+}
+
+/// Advance to the next event                                                 
+///   @return true if there was an event, false if the stream has ended       
+bool History::Stream::Next() {
+   // Stream spilled segments first                                     
+   while (mSegment < mHistory->mSegments.size()) {
+      if (mBounded and mTo < mHistory->mSegments[mSegment].mFrom) {
+         // This and all later segments begin after the range           
+         mFile.Close();
+         mSegment = mHistory->mSegments.size();
+         break;
+      }
+
+      if (not mFile and not OpenSegment())
+         break;
+
+      while (mLeft and mCursor + sizeof(HistoryRecord) <= mFile.GetSize()) {
+         HistoryRecord record;
+         ::std::memcpy(&record, mFile.GetRaw() + mCursor, sizeof(record));
+         const auto payload = mCursor + sizeof(HistoryRecord);
+         if (payload + record.mPayload > mFile.GetSize())
+            break;
+
+         mCursor = payload + AlignSection(record.mPayload);
+         --mLeft;
+
+         // Times are checked before anything is decoded                
+         ::std::memcpy(&mTime, record.mTime, sizeof(Time));
+         if (mBounded and mTime < mFrom)
+            continue;
+         if (mBounded and mTo < mTime) {
+            mLeft = 0;
+            break;
+         }
+
+         // A record that isn't a verb means the segment is corrupt, and
+         // nothing after it can be trusted                             
+         const auto decoded = DecodeDescriptor(mFile.GetRaw() + payload, record.mPayload);
+         if (decoded.IsEmpty() or not decoded.template Is<Verb>()) {
+            Logger::Warning("Skipping corrupt history segment `",
+               mHistory->mSegments[mSegment].mPath, '`');
+            mLeft = 0;
+            break;
+         }
+
+         mVerb = decoded.template As<Verb>();
+         if (mType and mVerb.GetVerb() != mType)
+            continue;
+         return true;
+      }
+
+      // Segment exhausted (or truncated), continue with the next one   
+      mFile.Close();
+      ++mSegment;
+   }
+
+   // Then the events that are still in memory                          
+   while (mRecent < mRecentEnd) {
+      const auto recent = mRecent++;
+      if (mType and mHistory->GetType(recent) != mType)
+         continue;
+
+      mTime = mHistory->GetTime(recent);
+      mVerb = mHistory->GetVerb(recent);
+      return true;
+   }
+   return false;
+}
+
+/// Get the time of the current event                                         
+///   @return the time                                                        
+auto History::Stream::GetTime() const noexcept -> Time {
+   return mTime;
+}
+
+/// Get the current event                                                     
+///   @return the verb                                                        
+auto History::Stream::GetVerb() const noexcept -> const Verb& {
+   return mVerb;
+}
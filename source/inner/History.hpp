@@ -0,0 +1,335 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Snapshot.hpp"
+#include "Storage.hpp"
+#include "Workers.hpp"
+#include <Langulus/Anyness/TMap.hpp>
+#include <Langulus/Anyness/TSet.hpp>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+
+///                                                                           
+///   History segment file layout                                             
+///                                                                           
+///   [HistorySegmentHeader]                                                  
+///   [HistoryRecord + serialized verb] ...                                   
+///                                                                           
+/// A segment is a sealed window of consecutive events, spilled to disk when  
+/// it is compacted out of the ring buffer. Segments are written once and     
+/// never modified, and are read back sequentially, one record at a time.     
+///                                                                           
+static_assert(::std::is_trivially_copyable_v<Time>,
+   "History segments store time as raw bytes");
+constexpr ::std::uint64_t HistoryTimeSize = AlignSection(sizeof(Time));
+
+struct HistorySegmentHeader {
+   static constexpr char Magic[8] = {'L','G','L','S','H','I','S','T'};
+   static constexpr ::std::uint32_t CurrentVersion = 1;
+   static constexpr ::std::uint32_t NativeEndianness = 0x01020304;
+
+   char            mMagic[8];
+   ::std::uint32_t mVersion;
+   ::std::uint32_t mEndianness;
+   // Sequence number of the first event in the segment                 
+   ::std::uint64_t mFirst;
+   ::std::uint64_t mCount;
+   ::std::uint8_t  mFrom[HistoryTimeSize];
+   ::std::uint8_t  mTo[HistoryTimeSize];
+};
+
+struct HistoryRecord {
+   ::std::uint64_t mPayload;
+   ::std::uint8_t  mTime[HistoryTimeSize];
+};
+
+static_assert(sizeof(HistorySegmentHeader) % 8 == 0);
+static_assert(sizeof(HistoryRecord) % 8 == 0);
+
+
+///                                                                           
+///   Tiered history of events                                                
+///                                                                           
+/// Recent events are kept verbatim in a fixed-size ring buffer. When it      
+/// fills up, its oldest window of events is compacted into a summary, that   
+/// only keeps how many times each verb type happened, and a limited number   
+/// of distinct verbs as samples. When there are too many summaries, the two  
+/// oldest ones are merged, so memory use never grows past the configured     
+/// budget.                                                                   
+///                                                                           
+/// The ring buffer is columnar - times, verb types, argument hashes and      
+/// verbs are kept in separate arrays, and every verb type has an index of    
+/// the events it occurs in. Events witnessed by many histories (for example, by all
+/// members of a society) can be stored once, in a shared store, and          
+/// merely referenced by sequence number in each of the histories.            
+/// Events are pushed in time order, so range queries are a binary search     
+/// over the times, and type queries are a binary search over the type        
+/// index, both followed by a walk over the results only. Spilled segments    
+/// are in time order too, so range queries over them skip whole segments,    
+/// but have to read the ones that overlap the range sequentially.            
+///                                                                           
+struct History {
+   /// Memory budget of a history                                             
+   struct Budget {
+      // Number of most recent events kept verbatim                     
+      Count mRecent = 1024;
+      // Number of oldest events that get compacted at once             
+      Count mWindow = 256;
+      // Number of summaries kept, before merging the oldest ones       
+      Count mSummaries = 64;
+      // Number of distinct verbs each summary keeps as samples         
+      Count mDistinct = 256;
+   };
+
+   // Events are identified by a sequence number, that keeps growing    
+   // as events are pushed, and is never reused                         
+   using Sequence = ::std::uint64_t;
+
+   // Entries with this bit set refer to an event in the store          
+   static constexpr Sequence Shared = Sequence {1} << 63;
+
+   /// A compacted window of older events                                     
+   struct Summary {
+      Time mFrom;
+      Time mTo;
+      Count mEvents = 0;
+      // How many times each verb type happened                         
+      TUnorderedMap<VMeta, Count> mCounts;
+      // Distinct verbs that happened, each once, up to a limit. Hashes 
+      // only rule verbs out quickly - verbs with the same hash are still
+      // compared, because they might differ                            
+      TMany<Verb> mDistinct;
+      TUnorderedSet<Hash> mHashes;
+
+      bool Contains(const Verb&) const;
+      void Keep(Verb&&);
+      void Merge(Summary&&, Count limit);
+   };
+
+   /// A spilled segment of events                                            
+   struct Segment {
+      Text mPath;
+      Sequence mFirst = 0;
+      Count mEvents = 0;
+      Time mFrom;
+      Time mTo;
+   };
+
+   /// Streams remembered events in time order - first the spilled            
+   /// segments, one mapped segment at a time, then the recent events.        
+   /// A stream can be limited to a time range, and to a verb type            
+   struct Stream {
+   private:
+      friend struct History;
+      const History* mHistory = nullptr;
+      Offset mSegment = 0;
+      MappedFile mFile;
+      Offset mCursor = 0;
+      Count mLeft = 0;
+      Offset mRecent = 0;
+      Offset mRecentEnd = 0;
+      Time mFrom;
+      Time mTo;
+      VMeta mType {};
+      bool mBounded = false;
+      Time mTime;
+      Verb mVerb;
+
+      Stream(const History*);
+      Stream(const History*, Time, Time, VMeta);
+      bool OpenSegment();
+
+   public:
+      bool Next();
+      auto GetTime() const noexcept -> Time;
+      auto GetVerb() const noexcept -> const Verb&;
+   };
+
+private:
+   Budget mBudget;
+
+   // Ring buffer of recent events, one column per event property.      
+   // Each entry is either the private sequence number of a verb in     
+   // mPrivate, or a Shared sequence number of an event in mStore.      
+   // Arguments are kept as hashes, to find events about something      
+   // without touching the verbs                                        
+   ::std::vector<Time> mTimes;
+   ::std::vector<VMeta> mTypes;
+   ::std::vector<Hash> mArguments;
+   ::std::vector<Sequence> mEntries;
+   Offset mHead = 0;
+   Count mCount = 0;
+
+   // Sequence number of the oldest recent event                        
+   Sequence mFirst = 0;
+
+   // Events from this sequence number on are never compacted - the     
+   // ring buffer grows past the budget instead, while they're pinned   
+   Sequence mPinned = ~Sequence {0};
+
+   // Sequence numbers of the recent events that refer to the store,    
+   // oldest first                                                      
+   ::std::deque<Sequence> mReferences;
+
+   // Verbs of private recent events, oldest first, and the private     
+   // sequence number of the oldest one                                 
+   ::std::deque<Verb> mPrivate;
+   Sequence mPrivateFirst = 0;
+
+   // History that stores the shared events                             
+   const History* mStore = nullptr;
+
+   // Sequence numbers of the recent events of each verb type. Indices  
+   // are never removed, so that their positions can be cached          
+   ::std::vector<::std::deque<Sequence>> mIndices;
+   TUnorderedMap<VMeta, Offset> mIndexOf;
+
+   // Most recently used verb type, and position of its index -         
+   // consecutive events are very often of the same type                
+   VMeta mLastType {};
+   Offset mLastIndex = 0;
+
+   // Summaries of older events, oldest first                           
+   ::std::vector<Summary> mSummaries;
+
+   // Spilled segments, oldest first, and the folder new ones go to.    
+   // Segments are encoded when spilled, but written to disk on a       
+   // background thread, so that updates never wait for the disk.       
+   // Segments are numbered by sequence, offset past any segments that  
+   // were already in the folder when a non-empty history began spilling
+   ::std::vector<Segment> mSegments;
+   Text mSpillFolder;
+   Sequence mSpillOffset = 0;
+   mutable Background mSpiller;
+
+   auto Slot(Offset) const noexcept -> Offset;
+   auto VerbAt(Offset) const noexcept -> const Verb&;
+   auto Resolve(Sequence) const noexcept -> const Verb*;
+   void Append(Time, VMeta, Hash, Sequence);
+   void Grow();
+   void PushPrivate(Time, VMeta, Verb&&);
+   void Rebuild(bool localize);
+   auto IndexOf(VMeta) -> ::std::deque<Sequence>&;
+   auto FindIndex(VMeta) const -> const ::std::deque<Sequence>*;
+   auto LowerBound(Time) const noexcept -> Offset;
+   auto UpperBound(Time) const noexcept -> Offset;
+   auto TypeRange(VMeta, Time, Time) const
+      -> ::std::pair<const ::std::deque<Sequence>*, ::std::pair<Offset, Offset>>;
+   void CompactOldest();
+   bool SpillOldest(Count);
+   void WaitForSpills() const;
+
+public:
+   History() = default;
+   History(const Budget&);
+
+   void SetBudget(const Budget&);
+   auto GetBudget() const noexcept -> const Budget&;
+
+   void Push(Time, const Verb&);
+   void Push(Time, Verb&&);
+   void Push(Time, TMany<Verb>&);
+   void Reference(Time, const History&, Sequence);
+   void Reference(Time, const History&, TMany<Sequence>&);
+   void Detach(const History&);
+   void Pin(Sequence);
+   void Reset();
+
+   auto GetCount() const noexcept -> Count;
+   auto GetSummaries() const noexcept -> const ::std::vector<Summary>&;
+
+   bool Spill(const Text&);
+   auto GetSegments() const noexcept -> const ::std::vector<Segment>&;
+   auto Replay() const -> Stream;
+   auto Replay(Time, Time, VMeta = {}) const -> Stream;
+
+   auto GetTime(Offset) const noexcept -> Time;
+   auto GetType(Offset) const noexcept -> VMeta;
+   auto GetVerb(Offset) const noexcept -> const Verb&;
+   auto GetNext() const noexcept -> Sequence;
+   auto GetOldestReference() const noexcept -> Sequence;
+   auto Find(Sequence) const noexcept -> const Verb*;
+
+   auto Range(Time, Time) const noexcept -> ::std::pair<Offset, Offset>;
+   auto CountOf(VMeta) const -> Count;
+   auto CountOf(VMeta, Time, Time) const -> Count;
+
+   /// Count how many times a verb happened, including compacted events       
+   ///   @tparam V - the verb to count                                        
+   ///   @return the number of times V happened                               
+   template<CT::Verb V>
+   auto CountOf() const -> Count {
+      return CountOf(MetaVerbOf<V>());
+   }
+
+   /// Iterate recent events, from the oldest to the newest                   
+   ///   @param call - function to invoke with each Time and const Verb&      
+   template<class F>
+   void ForEach(F&& call) const {
+      for (Offset i = 0; i < mCount; ++i) {
+         const auto s = Slot(i);
+         call(mTimes[s], VerbAt(s));
+      }
+   }
+
+   /// Iterate recent events in the time range [from; to]                     
+   /// Older events can be streamed with Replay(from, to)                     
+   ///   @param from - the earliest time, inclusive                           
+   ///   @param to - the latest time, inclusive                               
+   ///   @param call - function to invoke with each Time and const Verb&      
+   template<class F>
+   void ForEachIn(Time from, Time to, F&& call) const {
+      const auto [begin, end] = Range(from, to);
+      for (auto i = begin; i < end; ++i) {
+         const auto s = Slot(i);
+         call(mTimes[s], VerbAt(s));
+      }
+   }
+
+   /// Iterate recent events of a verb type in the time range [from; to]      
+   /// Older events can be streamed with Replay(from, to, type)               
+   ///   @param type - the verb type to look for                              
+   ///   @param from - the earliest time, inclusive                           
+   ///   @param to - the latest time, inclusive                               
+   ///   @param call - function to invoke with each Time and const Verb&      
+   template<class F>
+   void ForEachOf(VMeta type, Time from, Time to, F&& call) const {
+      const auto [index, range] = TypeRange(type, from, to);
+      if (not index)
+         return;
+
+      for (auto i = range.first; i < range.second; ++i) {
+         const auto s = Slot(static_cast<Offset>((*index)[i] - mFirst));
+         call(mTimes[s], VerbAt(s));
+      }
+   }
+
+   /// Iterate recent events about an argument in the time range [from; to]   
+   /// Only events with a matching argument hash have their verbs compared    
+   ///   @param argument - the argument to look for                           
+   ///   @param from - the earliest time, inclusive                           
+   ///   @param to - the latest time, inclusive                               
+   ///   @param call - function to invoke with each Time and const Verb&      
+   template<class F>
+   void ForEachAbout(const Many& argument, Time from, Time to, F&& call) const {
+      const auto hash = argument.GetHash();
+      const auto [begin, end] = Range(from, to);
+      for (auto i = begin; i < end; ++i) {
+         const auto s = Slot(i);
+         if (mArguments[s] != hash)
+            continue;
+
+         const auto& verb = VerbAt(s);
+         if (verb.GetArgument() == argument)
+            call(mTimes[s], verb);
+      }
+   }
+};
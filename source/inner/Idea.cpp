@@ -16,12 +16,15 @@
 Idea::Idea(Ontology* producer, const Many& data)
    : ProducedFrom {producer, data} {
    VERBOSE_AI_BUILD("Defining idea for: ", data);
+   if (producer)
+      producer->Register(*this);
 }
 
 /// Tear apart all ideas before destroying them to avoid circular dependencies
 void Idea::Teardown() {
    mDisassociations.Reset();
    mAssociations.Reset();
+   mBase = nullptr;
 }
 
 /// Get the ontology interface                                                
@@ -30,31 +33,82 @@ auto Idea::GetOntology() const -> Ontology* {
    return mProducer;
 }
 
+/// Get the shared idea this one shadows, as seen by the current thread       
+///   @return the shared idea, or nullptr if the idea shadows nothing yet     
+auto Idea::GetBase() const -> const Idea* {
+   const auto base = mBase.load();
+   return base and mBased.load() <= GetOntology()->GetEpoch() ? base : nullptr;
+}
+
+/// Iterate the links of the idea, as seen by the current thread, including   
+/// the links of all the shared ideas it shadows, layer by layer. Shared      
+/// ideas are substituted with their shadows in the owner, or in any of       
+/// the layers in between                                                     
+///   @tparam ASSOCIATIONS - true for associations, false for disassociations 
+///   @param call - function to call with each const Idea*, returning Loop    
+template<bool ASSOCIATIONS, class F>
+void Idea::ForEachLink(F&& call) const {
+   const auto ontology = GetOntology();
+   for (auto idea = this; idea; idea = idea->GetBase()) {
+      const auto& links = ASSOCIATIONS ? idea->mAssociations : idea->mDisassociations;
+      for (auto link : idea->Visible(links)) {
+         if (call(ontology->Overlay(link)) == Loop::Break)
+            return;
+      }
+   }
+}
+
+/// Check if the idea is linked to another, as seen by the current thread     
+///   @tparam ASSOCIATIONS - true for associations, false for disassociations 
+///   @param what - the idea to search for                                    
+///   @return true if linked                                                  
+template<bool ASSOCIATIONS>
+bool Idea::IsLinked(const Idea* what) const {
+   what = GetOntology()->Overlay(what);
+   bool found = false;
+   ForEachLink<ASSOCIATIONS>([&](const Idea* idea) {
+      found = idea == what;
+      return found ? Loop::Break : Loop::Continue;
+   });
+   return found;
+}
+
 /// Associate/Disassociate with a single idea                                 
 ///   @tparam ASSOCIATE - true to associate, false to disassociate            
 ///   @param idea - the idea to (dis)associate with                           
 ///   @return true if the idea was added as (dis)association                  
 template<bool ASSOCIATE>
 bool Idea::LinkIdea(Idea* idea) {
-   if (idea->GetOntology() != GetOntology()) {
-      Logger::Error(
-         "Can't (dis)associate ideas produced from different ontologies."
-         "Trying to (dis)associate ", *this, " from/with ", *idea
-      );
-      return false;  //TODO transfer idea somehow? 
-                     // should generally happen through communication though
+   // Ideas from a shared layer are shadowed, and the shadow is linked  
+   // instead, so that the shared layer remains untouched               
+   if (GetOntology()->IsSharing(idea->GetOntology()))
+      idea = GetOntology()->Shadow(idea);
+   else if (idea->GetOntology() != GetOntology()) {
+      // Ideas from other ontologies are transferred first, without     
+      // any of their links - communication transfers those in batches  
+      Ideas single;
+      single << idea;
+      idea = GetOntology()->Transfer(*idea->GetOntology(), single, 1)[0];
+      if (idea->GetOntology() != GetOntology())
+         idea = GetOntology()->Shadow(idea);
    }
 
-   // Always symmetrical                                                
+   // Always symmetrical, but only directions that weren't linked yet   
+   // are journaled, or replay would repeat them                        
+   const auto ontology = GetOntology();
    if constexpr (ASSOCIATE) {
-      mAssociations <<= idea;
-      idea->mAssociations <<= this;
-      Logger::Info(Logger::Green, "Associated ", *this, " with ", *idea);
+      if (ontology->AddLink(mAssociations, idea))
+         ontology->Linked(*this, *idea, true);
+      if (ontology->AddLink(idea->mAssociations, this))
+         ontology->Linked(*idea, *this, true);
+      VERBOSE_AI(Logger::Green, "Associated with ", *idea);
    }
    else {
-      mDisassociations <<= idea;
-      idea->mDisassociations <<= this;
-      Logger::Info(Logger::Green, "Disassociated ", *this, " from ", *idea);
+      if (ontology->AddLink(mDisassociations, idea))
+         ontology->Linked(*this, *idea, false);
+      if (ontology->AddLink(idea->mDisassociations, this))
+         ontology->Linked(*idea, *this, false);
+      VERBOSE_AI(Logger::Green, "Disassociated from ", *idea);
    }
 
    return true;
@@ -106,24 +160,26 @@ void Idea::Equal(Verb& verb) const {
    // Check if the required associations are available                  
    if (verb.IsDeep()) {
       TODO();     // must generate a new idea and check against that
-                  // preserve hierarchy!
+                  // preserve hierarchy!                                
    }
    else verb.ForEach([&](Idea* idea) {
-      if (this != idea and (not mAssociations.Contains(idea)
-                            or  mDisassociations.Contains(idea))
+      if (this != idea and (not IsLinked<true>(idea)
+                            or  IsLinked<false>(idea))
       ) {
          // First order mismatch found, so ideas are not plainly similar
          // We have to do an advanced graph-walking comparison to make  
          // sure that there doesn't exist any indirect associations.    
          IdeaSet mask;
-         if (not AdvancedCompare(idea, mask)) {
+         const auto similar = AdvancedCompare(idea, mask);
+         Metrics::Record(Metrics::EqualVisits, mask.GetCount());
+         if (not similar) {
             // Full mismatch found, no point in going further           
             verb.Done();
             matches = 0;
             return Loop::Break;
          }
       }
-      
+
       ++matches;
       return Loop::Continue;
    });
@@ -139,31 +195,29 @@ void Idea::Equal(Verb& verb) const {
 ///   @param mask - a set of covered ideas to avoid infinite regresses        
 ///   @return the idea which contained the association (if found)             
 auto Idea::AdvancedCompare(const Idea* what, IdeaSet& mask) const -> const Idea* {
+   AI_TRACE("Idea::AdvancedCompare");
    if (mask.Contains(this))
       return nullptr;
 
    mask << this;
-   
-   // Make sure that the idea is never found in any disassociations     
-   for (auto idea : mDisassociations) {
-      if (idea == what)
-         return nullptr;
-   }
 
-   for (auto idea : what->mDisassociations) {
-      if (idea == this)
-         return nullptr;
-   }
+   // Make sure that the idea is never found in any disassociations     
+   if (IsLinked<false>(what) or what->IsLinked<false>(this))
+      return nullptr;
 
    // Check if idea is found down the associations rabbit hole          
-   for (auto idea : mAssociations) {
+   const Idea* found = nullptr;
+   ForEachLink<true>([&](const Idea* idea) {
       if (idea == what or (idea->AdvancedCompare(what, mask)
-                       and what->AdvancedCompare(idea, mask)))
-         return this;
-   }
+                       and what->AdvancedCompare(idea, mask))) {
+         found = this;
+         return Loop::Break;
+      }
+      return Loop::Continue;
+   });
 
    // If reached, then no association was found                         
-   return nullptr;
+   return found;
 }
 
 /// Compare crumb ratings                                                     
@@ -180,24 +234,38 @@ bool Idea::operator < (const Idea& other) const noexcept {
    return mRating < other.mRating;
 }
 
-/// Get the list of associations                                              
+/// Get the associations, as seen by the current thread                       
 ///   @return the contained associations                                      
-auto Idea::GetAssociations() const noexcept -> const Ideas& {
-   return mAssociations;
+auto Idea::GetAssociations() const -> Links::View {
+   return Visible(mAssociations);
+}
+
+/// Get the disassociations, as seen by the current thread                    
+///   @return the contained disassociations                                   
+auto Idea::GetDisassociations() const -> Links::View {
+   return Visible(mDisassociations);
+}
+
+/// Get the version of some links, visible to the current thread - readers    
+/// see the version of their view, while the writer sees the latest one       
+///   @param links - the links to view                                        
+///   @return the visible version of the links                                
+auto Idea::Visible(const Links& links) const -> Links::View {
+   return links.Read(GetOntology()->GetEpoch());
 }
 
 /// Check if crumb has a given association                                    
 ///   @param n - the idea to check if inside associations                     
 ///   @return true if the idea is inside list of associations                 
 bool Idea::HasAssociation(const Idea* n) const {
-   return mAssociations.Contains(n);
+   return IsLinked<true>(n);
 }
 
 /// Check if crumb has a given disassociation                                 
 ///   @param n - the idea to check if inside disassociations                  
 ///   @return true if the idea is inside list of disassociations              
 bool Idea::HasDisassociation(const Idea* n) const {
-   return mDisassociations.Contains(n);
+   return IsLinked<false>(n);
 }
 
 /// Associate this crumb with some data. Symmetic association                 
@@ -206,7 +274,8 @@ void Idea::Associate(Idea* n) {
    if (HasAssociation(n))
       return;
 
-   mAssociations << n;
+   GetOntology()->AddLink(mAssociations, n);
+   GetOntology()->Linked(*this, *n, true);
    VERBOSE_AI_SEEK("Decoder: ", Logger::Cyan, this, Logger::Gray,
                    " now synonym to ", Logger::Cyan, n);
 }
@@ -217,7 +286,8 @@ void Idea::Disassociate(Idea* n) {
    if (HasDisassociation(n))
       return;
 
-   mDisassociations << n;
+   GetOntology()->AddLink(mDisassociations, n);
+   GetOntology()->Linked(*this, *n, false);
    VERBOSE_AI_SEEK("Decoder: ", Logger::Cyan, this, Logger::Gray,
                    " now antonym to ", Logger::Cyan, n);
 }
@@ -258,8 +328,9 @@ void Idea::Interpret(Verb& verb) const {
    verb.ForEachDeep([&](DMeta type) {
       IdeaSet mask;
       auto found = ExtractInner(type, mask);
+      Metrics::Record(Metrics::ExtractVisits, mask.GetCount());
       if (found) {
-         Logger::Verbose(Logger::Green, "Interpreted ", *this, " as ", found);
+         VERBOSE_AI(Logger::Green, "Interpreted ", *this, " as ", found);
          verb << Abandon(found);
       }
    });
@@ -273,6 +344,7 @@ void Idea::Interpret(Verb& verb) const {
 ///   @param mask - a set of covered ideas to avoid infinite regresses        
 ///   @return the extracted hierarchy of instances of T                       
 Many Idea::ExtractInner(DMeta what, IdeaSet& mask) const {
+   AI_TRACE("Idea::ExtractInner");
    if (mask.Contains(this))
       return {};
    mask << this;
@@ -281,20 +353,23 @@ Many Idea::ExtractInner(DMeta what, IdeaSet& mask) const {
    auto result = ExtractInnerInner(what, mDescriptor);
 
    // Make sure nothing is extracted from disassociations               
-   for (auto idea : mDisassociations)
+   ForEachLink<false>([&](const Idea* idea) {
       mask << idea;
+      return Loop::Continue;
+   });
 
    // Check if any relevant data is found in any associations           
-   for (auto idea : mAssociations) {
+   ForEachLink<true>([&](const Idea* idea) {
       auto deeper = idea->ExtractInner(what, mask);
       if (deeper)
          result <<= deeper;
-   }
+      return Loop::Continue;
+   });
 
    return result;
 }
 
-///TODO move this to Block::Distill?                                          
+///TODO move this to Block::Distill?
 Many Idea::ExtractInnerInner(DMeta what, const Many& data) const {
    if (data.IsDeep()) {
       // Nest compilation. No escape from this branch                   
@@ -6,7 +6,9 @@
 /// SPDX-License-Identifier: GPL-3.0-or-later                                 
 ///                                                                           
 #pragma once
-#include "../Common.hpp"
+#include "Links.hpp"
+#include "Metrics.hpp"
+#include "Trace.hpp"
 #include <Langulus/Anyness/TSet.hpp>
 #include <Langulus/Flow/Producible.hpp>
 #include <Langulus/Verbs/Do.hpp>
@@ -14,10 +16,8 @@
 #include <Langulus/Verbs/Equal.hpp>
 #include <Langulus/Verbs/Interpret.hpp>
 
-struct Idea;
 struct Ontology;
 
-using Ideas   = TMany<Idea*>;
 using IdeaSet = TSet<const Idea*>;
 using Rating  = Real;
 
@@ -37,14 +37,29 @@ struct Idea : Referenced, ProducedFrom<Ontology> {
 protected:
    friend struct Ontology;
 
+   // Index of the idea in the order of creation inside its ontology    
+   Offset mIndex = 0;
+   // Epoch in which the idea was learned - readers with older views    
+   // don't see it                                                      
+   Epoch mEpoch = 0;
+   // Epoch in which the idea was forgotten - readers with newer views  
+   // don't see it, and it is destroyed once no older views remain      
+   static constexpr Epoch Remembered = ~Epoch {0};
+   Epoch mForgotten = Remembered;
+   // The shared idea this one shadows, if the ontology is layered over 
+   // a shared one - only what was learned on top of it is kept here.   
+   // Ideas begin shadowing in the epoch they're based in, so that      
+   // readers with older views don't inherit anything from them yet     
+   ::std::atomic<const Idea*> mBase = nullptr;
+   ::std::atomic<Epoch> mBased = 0;
    // Usage and relevance ratings                                       
    Rating mRating = 0;
    // Associations                                                      
    // Facilitates pattern connections, synonimity and equivalence       
-   Ideas mAssociations;
+   Links mAssociations;
    // Disassociations                                                   
    // Facilitates inhibitory connections and suppresses equivalence     
-   Ideas mDisassociations;
+   Links mDisassociations;
 
 public:
    Idea(Ontology*, const Many&);
@@ -65,14 +80,16 @@ public:
    template<CT::Flat T>
    Many Extract() const {
       IdeaSet mask;
-      return ExtractInner(MetaDataOf<T>(), mask);
+      auto found = ExtractInner(MetaDataOf<T>(), mask);
+      Metrics::Record(Metrics::ExtractVisits, mask.GetCount());
+      return found;
    }
 
    bool operator > (const Idea&) const noexcept;
    bool operator < (const Idea&) const noexcept;
 
-   auto GetAssociations()    const noexcept -> const Ideas&;
-   auto GetDisassociations() const noexcept -> const Ideas&;
+   auto GetAssociations()    const -> Links::View;
+   auto GetDisassociations() const -> Links::View;
 
    bool HasAssociation     (const Idea*) const;
    bool HasDisassociation  (const Idea*) const;
@@ -90,4 +107,10 @@ private:
    Many ExtractInnerInner(DMeta, const Many&) const;
    Text Self() const;
    void Link(Idea*, Ideas&);
+   auto Visible(const Links&) const -> Links::View;
+   auto GetBase() const -> const Idea*;
+   template<bool ASSOCIATIONS, class F>
+   void ForEachLink(F&&) const;
+   template<bool ASSOCIATIONS>
+   bool IsLinked(const Idea*) const;
 };
\ No newline at end of file
@@ -0,0 +1,483 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Journal.hpp"
+#include "Snapshot.hpp"
+#include "Ontology.hpp"
+#include <cstdio>
+#include <cstring>
+
+
+/// Compute a FNV-1a checksum of the record and its payload                   
+///   @param payload - the payload that follows the record                    
+///   @return the checksum                                                    
+auto JournalRecord::ComputeChecksum(const Byte* payload) const noexcept
+-> ::std::uint32_t {
+   ::std::uint32_t hash = 2166136261u;
+   const auto mix = [&hash](const Byte* data, Size size) {
+      for (Size i = 0; i < size; ++i) {
+         hash ^= static_cast<::std::uint32_t>(data[i]);
+         hash *= 16777619u;
+      }
+   };
+
+   mix(reinterpret_cast<const Byte*>(&mType), sizeof(mType));
+   mix(reinterpret_cast<const Byte*>(&mPayload), sizeof(mPayload));
+   mix(reinterpret_cast<const Byte*>(&mFrom), sizeof(mFrom));
+   mix(reinterpret_cast<const Byte*>(&mTo), sizeof(mTo));
+   if (payload)
+      mix(payload, mPayload);
+   return hash;
+}
+
+/// Flush everything and stop the background writer                           
+Journal::~Journal() {
+   Close();
+}
+
+/// Start a new journal, discarding any previous contents of the file         
+///   @param path - the journal file                                          
+///   @param baseIdeas - number of ideas in the base image                    
+///   @param generation - the generation of the journal                       
+///   @return true if the journal was opened                                  
+bool Journal::Open(const Text& path, Count baseIdeas, ::std::uint64_t generation) {
+   Close();
+   if (not mFile.Open(path))
+      return false;
+
+   JournalHeader header {};
+   ::std::memcpy(header.mMagic, JournalHeader::Magic, sizeof(header.mMagic));
+   header.mVersion = JournalHeader::CurrentVersion;
+   header.mBaseIdeas = static_cast<::std::uint32_t>(baseIdeas);
+   header.mGeneration = generation;
+   if (not mFile.WritePOD(header) or not mFile.Flush()) {
+      mFile.Close();
+      return false;
+   }
+
+   mPath = path;
+   mSize = sizeof(JournalHeader);
+   mRunning = true;
+   mFlusher = ::std::thread {&Journal::FlusherLoop, this};
+   return true;
+}
+
+/// Write all pending records, stop the writer and close the file             
+void Journal::Close() {
+   if (mFlusher.joinable()) {
+      {
+         ::std::lock_guard lock {mMutex};
+         mRunning = false;
+      }
+      mWake.notify_one();
+      mFlusher.join();
+   }
+
+   mFile.Close();
+   mPending.clear();
+   mFlushing.clear();
+   mSize = 0;
+}
+
+/// Ask the writer to write pending records right away, instead of waiting    
+/// for the next interval                                                     
+void Journal::Commit() {
+   {
+      ::std::lock_guard lock {mMutex};
+      mFlushRequested = true;
+   }
+   mWake.notify_one();
+}
+
+/// Append a record to the pending batch                                      
+///   @param record - the record to append, checksum will be computed here    
+///   @param payload - the payload that follows the record, if any            
+void Journal::Append(const JournalRecord& record, const Byte* payload) {
+   auto r = record;
+   r.mChecksum = r.ComputeChecksum(payload);
+
+   const auto aligned = AlignSection(r.mPayload);
+   const auto head = reinterpret_cast<const Byte*>(&r);
+
+   ::std::lock_guard lock {mMutex};
+   mPending.insert(mPending.end(), head, head + sizeof(r));
+   if (payload)
+      mPending.insert(mPending.end(), payload, payload + r.mPayload);
+   mPending.resize(mPending.size() + (aligned - r.mPayload), Byte {0});
+   mSize += sizeof(r) + aligned;
+}
+
+/// Record the creation of an idea                                            
+///   @param index - the index the idea was registered with                   
+///   @param blob - the idea's descriptor blob, see Ontology::Encode          
+void Journal::LogCreate(Offset index, const Bytes& blob) {
+   if (not mRunning)
+      return;
+
+   JournalRecord record {};
+   record.mType = JournalRecord::Create;
+   record.mPayload = static_cast<::std::uint32_t>(blob.GetCount());
+   record.mFrom = static_cast<::std::uint32_t>(index);
+   Append(record, blob.GetRaw());
+}
+
+/// Record a directed (dis)association                                        
+///   @param from - index of the idea that was linked                         
+///   @param to - index of the idea it was linked to                          
+///   @param type - either JournalRecord::Associate or Disassociate           
+void Journal::LogLink(Offset from, Offset to, JournalRecord::Type type) {
+   if (not mRunning)
+      return;
+
+   JournalRecord record {};
+   record.mType = type;
+   record.mFrom = static_cast<::std::uint32_t>(from);
+   record.mTo = static_cast<::std::uint32_t>(to);
+   Append(record, nullptr);
+}
+
+/// Record the destruction of an idea                                         
+///   @param index - the index of the idea                                    
+void Journal::LogDestroy(Offset index) {
+   if (not mRunning)
+      return;
+
+   JournalRecord record {};
+   record.mType = JournalRecord::Destroy;
+   record.mFrom = static_cast<::std::uint32_t>(index);
+   Append(record, nullptr);
+}
+
+/// Background writer - periodically moves the pending batch to the file      
+void Journal::FlusherLoop() {
+   ::std::unique_lock lock {mMutex};
+   while (true) {
+      mWake.wait_for(lock, mInterval, [this] {
+         return not mRunning or mFlushRequested;
+      });
+
+      const bool stopping = not mRunning;
+      mFlushRequested = false;
+      if (not mPending.empty()) {
+         mPending.swap(mFlushing);
+         lock.unlock();
+         WritePending();
+         lock.lock();
+      }
+
+      if (stopping)
+         return;
+   }
+}
+
+/// Write and synchronize the batch that was taken by the writer              
+void Journal::WritePending() {
+   if (not mFile.Write(mFlushing.data(), mFlushing.size())
+   or  not mFile.Flush())
+      Logger::Error("Failed writing ontology journal `", mPath, '`');
+   mFlushing.clear();
+}
+
+/// Get the size of the journal, including pending records                    
+///   @return the size in bytes                                               
+auto Journal::GetSize() const noexcept -> Size {
+   return mSize;
+}
+
+/// Get the file the journal is written to                                    
+///   @return the path                                                        
+auto Journal::GetPath() const noexcept -> const Text& {
+   return mPath;
+}
+
+/// Check if the journal is recording                                         
+///   @return true if journal is open                                         
+bool Journal::IsOpen() const noexcept {
+   return mRunning;
+}
+
+/// Change how often pending records are written                              
+///   @param interval - the new interval                                      
+void Journal::SetInterval(Clock::duration interval) noexcept {
+   mInterval = interval;
+}
+
+
+/// Apply a journal on top of the ontology. The ontology must contain exactly 
+/// the base image the journal was started from. Replay stops at the first    
+/// incomplete record, which is where the process crashed                     
+///   @param path - the journal file                                          
+///   @return true if the journal was applied, or was already folded into     
+///      the base image                                                       
+bool Ontology::Replay(const Text& path) {
+   MappedFile file;
+   if (not file.Open(path)) {
+      Logger::Error(Self(), "Can't map journal `", path, '`');
+      return false;
+   }
+
+   const auto raw = file.GetRaw();
+   const auto size = file.GetSize();
+   if (size < sizeof(JournalHeader)) {
+      // The process crashed while starting the journal                 
+      Logger::Warning(Self(), "Journal `", path, "` has no records");
+      return true;
+   }
+
+   JournalHeader header;
+   ::std::memcpy(&header, raw, sizeof(header));
+   if (::std::memcmp(header.mMagic, JournalHeader::Magic, sizeof(header.mMagic))
+   or  header.mVersion != JournalHeader::CurrentVersion) {
+      Logger::Error(Self(), "`", path, "` is not a supported journal");
+      return false;
+   }
+
+   if (header.mGeneration < mGeneration) {
+      // The process stopped after the journal was folded into the base 
+      // image, but before the journal was removed                      
+      VERBOSE_AI("Journal `", path, "` was already folded");
+      return true;
+   }
+
+   if (header.mGeneration > mGeneration or header.mBaseIdeas != mOrder.GetCount()) {
+      Logger::Error(Self(), "Journal `", path, "` doesn't continue from the "
+         "base image - it continues from ", header.mBaseIdeas, " ideas, "
+         "but there are ", mOrder.GetCount());
+      return false;
+   }
+
+   Count records = 0;
+   Size at = sizeof(JournalHeader);
+   while (at <= size and size - at >= sizeof(JournalRecord)) {
+      JournalRecord record;
+      ::std::memcpy(&record, raw + at, sizeof(record));
+      const auto payload = raw + at + sizeof(record);
+      if (record.mPayload > size - at - sizeof(record)
+      or  record.ComputeChecksum(record.mPayload ? payload : nullptr) != record.mChecksum)
+         break;
+
+      if (record.mType == JournalRecord::Create) {
+         // Ideas made of other ideas refer to them by their index, and 
+         // those were always created by an earlier record              
+         DecodedIdea descriptor;
+         bool known = DecodeIdea(payload, record.mPayload, descriptor);
+         Ideas parts;
+         if (descriptor.mKind == SnapshotDescriptor::Alternatives)
+            parts.MakeOr();
+         for (auto part : descriptor.mParts) {
+            if (part >= mOrder.GetCount()) {
+               known = false;
+               break;
+            }
+            parts << mOrder[part];
+         }
+
+         if (not known) {
+            Logger::Error(Self(), "Journal `", path, "` creates an idea "
+               "from unknown ideas at record #", records);
+            return false;
+         }
+
+         auto idea = Spawn(descriptor.mKind == SnapshotDescriptor::Data
+            ? descriptor.mData : Many {parts});
+         if (idea->mIndex != record.mFrom) {
+            Logger::Error(Self(), "Journal `", path, "` diverged from the "
+               "ontology at record #", records);
+            return false;
+         }
+      }
+      else if (record.mFrom >= mOrder.GetCount()
+      or (record.mType != JournalRecord::Destroy and record.mTo >= mOrder.GetCount())) {
+         Logger::Error(Self(), "Journal `", path, "` refers to unknown "
+            "ideas at record #", records);
+         return false;
+      }
+      else if (record.mType == JournalRecord::Destroy)
+         Forget(mOrder[record.mFrom]);
+      else {
+         auto from = mOrder[record.mFrom];
+         auto to = mOrder[record.mTo];
+         if (record.mType == JournalRecord::Associate)
+            AddLink(from->mAssociations, to);
+         else
+            AddLink(from->mDisassociations, to);
+      }
+
+      at += sizeof(record) + AlignSection(record.mPayload);
+      ++records;
+   }
+
+   if (at < size) {
+      Logger::Warning(Self(), "Journal `", path, "` ends with an incomplete "
+         "record - ", size - at, " bytes were lost");
+   }
+
+   // The ontology now continues from where the journal ended           
+   ++mGeneration;
+   mCache.Clear();
+   VERBOSE_AI("Replayed ", records, " records from journal `", path, '`');
+   return true;
+}
+
+/// Load the base image of a persistent ontology, if there is one, and        
+/// continue from the journal generation it was made at                       
+///   @param base - the base image file                                       
+///   @return true if there's no base image, or if it was loaded              
+bool Ontology::LoadBase(const Text& base) {
+   MappedFile image;
+   if (not image.Open(base))
+      return true;
+
+   Ideas loaded;
+   if (not LoadImage(image.GetRaw(), image.GetSize(), loaded)) {
+      Logger::Error(Self(), "Can't load base image `", base, '`');
+      return false;
+   }
+
+   SnapshotHeader header;
+   ::std::memcpy(&header, image.GetRaw(), sizeof(header));
+   mGeneration = header.mGeneration;
+   return true;
+}
+
+/// Write the ontology aside, and swap it in place of a file, so that a       
+/// crash never leaves a partially written image behind                       
+///   @param path - the image to replace                                      
+///   @return true if the image was replaced                                  
+bool Ontology::SaveAtomically(const Text& path) const {
+   const auto staging = path + ".tmp";
+   if (not Save(staging))
+      return false;
+
+   if (not ReplaceFile(staging, path)) {
+      Logger::Error(Self(), "Can't replace image `", path, '`');
+      return false;
+   }
+
+   return true;
+}
+
+/// Make the ontology persistent. Loads the base image and replays the        
+/// journals if they exist, then compacts them into a new base image, and     
+/// starts journaling every mutation from there on                            
+///   @param base - the base image file                                       
+///   @param journal - the journal file                                       
+///   @return true if the ontology is now persistent                          
+bool Ontology::Persist(const Text& base, const Text& journal) {
+   if (mPager.IsActive()) {
+      Logger::Error(Self(), "Can't make a paged ontology persistent");
+      return false;
+   }
+
+   mCompactor.Stop();
+   if (not LoadBase(base))
+      return false;
+
+   // A journal that was still being folded when the process stopped    
+   // goes before the one that continued from it. If any of them can't  
+   // be replayed, nothing is compacted, so that it isn't lost          
+   for (const auto& path : {journal + ".old", journal}) {
+      MappedFile previous;
+      if (not previous.Open(path))
+         continue;
+
+      previous.Close();
+      if (not Replay(path)) {
+         Logger::Error(Self(), "Can't recover from journal `", path,
+            "` - the ontology won't be persistent");
+         return false;
+      }
+   }
+
+   mBasePath = base;
+   return Compact(journal);
+}
+
+/// Fold the journals into the base image and restart journaling              
+///   @param journal - the journal to restart                                 
+///   @return true if compaction succeeded                                    
+bool Ontology::Compact(const Text& journal) {
+   if (not mBasePath) {
+      Logger::Error(Self(), "Can't compact an ontology that isn't persistent");
+      return false;
+   }
+
+   mCompactor.Stop();
+   mJournal.Close();
+   if (not SaveAtomically(mBasePath))
+      return false;
+
+   // Everything is in the base image now, so a journal that was left   
+   // from an unfinished compaction can go                              
+   const auto folded = journal + ".old";
+   MappedFile previous;
+   if (previous.Open(folded)) {
+      previous.Close();
+      RemoveFile(folded);
+   }
+
+   if (not mJournal.Open(journal, mOrder.GetCount(), mGeneration)) {
+      Logger::Error(Self(), "Can't open journal `", journal, '`');
+      return false;
+   }
+
+   return true;
+}
+
+/// Start a new journal, and fold the previous one into the base image on a   
+/// background thread, so that the owner never waits for the image to be      
+/// written                                                                   
+void Ontology::CompactLater() {
+   const Text journal = mJournal.GetPath();
+   const auto folded = journal + ".old";
+
+   // Closing the journal writes and synchronizes all pending records   
+   mJournal.Close();
+   if (not ReplaceFile(journal, folded)) {
+      Logger::Error(Self(), "Can't set journal `", journal, "` aside - "
+         "compacting right away");
+      Compact(journal);
+      return;
+   }
+
+   // The new journal continues from the folded one                     
+   ++mGeneration;
+   if (not mJournal.Open(journal, mOrder.GetCount(), mGeneration)) {
+      Logger::Error(Self(), "Can't open journal `", journal, '`');
+      return;
+   }
+
+   mCompacting = true;
+   mCompactor.Submit([this, base = mBasePath, folded] {
+      Fold(base, folded);
+      mCompacting = false;
+   });
+}
+
+/// Fold a journal into a base image, without involving any live ontology     
+///   @param base - the base image, that the journal continues from           
+///   @param journal - the journal to fold, removed when folded               
+///   @return true if the journal was folded                                  
+bool Ontology::Fold(const Text& base, const Text& journal) {
+   Ontology scratch;
+   const bool folded = scratch.LoadBase(base)
+                   and scratch.Replay(journal)
+                   and scratch.SaveAtomically(base)
+                   and RemoveFile(journal);
+   scratch.Teardown();
+
+   if (not folded) {
+      Logger::Error("Failed folding journal `", journal, "` into `", base, '`');
+      return false;
+   }
+
+   // Folding isn't done by any ontology, so there's no Self() to log as
+   #if VERBOSE_AI_ENABLED()
+      Logger::Verbose("Folded journal `", journal, "` into `", base, '`');
+   #endif
+   return true;
+}
@@ -0,0 +1,120 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Storage.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+///                                                                           
+///   Journal file layout                                                     
+///                                                                           
+///   [JournalHeader]                                                         
+///   [JournalRecord + payload] ...                                           
+///                                                                           
+/// Records are only ever appended. Each one carries a checksum, so that a    
+/// record torn by a crash is detected, and replay stops right before it.     
+///                                                                           
+struct JournalHeader {
+   static constexpr char Magic[8] = {'L','G','L','S','J','R','N','L'};
+   static constexpr ::std::uint32_t CurrentVersion = 3;
+
+   char            mMagic[8];
+   ::std::uint32_t mVersion;
+   // Number of ideas in the base image this journal continues from     
+   ::std::uint32_t mBaseIdeas;
+   // Journals are numbered, so that one that was already folded into   
+   // the base image is never replayed again                            
+   ::std::uint64_t mGeneration;
+};
+
+struct JournalRecord {
+   enum Type : ::std::uint32_t {
+      // A new idea, payload is its descriptor blob (see Snapshot.hpp)  
+      Create = 1,
+      // A directed association, no payload                             
+      Associate = 2,
+      // A directed disassociation, no payload                          
+      Disassociate = 3,
+      // A forgotten idea, no payload - the last idea takes its index   
+      Destroy = 4
+   };
+
+   ::std::uint32_t mType;
+   ::std::uint32_t mPayload;
+   // Index of the created or destroyed idea, or the source of a link   
+   ::std::uint32_t mFrom;
+   // Index of the target of a link                                     
+   ::std::uint32_t mTo;
+   ::std::uint32_t mChecksum;
+   ::std::uint32_t mReserved;
+
+   auto ComputeChecksum(const Byte*) const noexcept -> ::std::uint32_t;
+};
+
+static_assert(sizeof(JournalHeader) % 8 == 0);
+static_assert(sizeof(JournalRecord) % 8 == 0);
+
+
+///                                                                           
+///   Append-only journal of ontology mutations                               
+///                                                                           
+/// Records are gathered into a pending batch on the thread that mutates the  
+/// ontology, and a background thread periodically writes and synchronizes    
+/// them, so the frame thread never waits on the storage device. On a crash   
+/// only the batch that was still pending is lost.                            
+///                                                                           
+struct Journal {
+   using Clock = ::std::chrono::steady_clock;
+
+private:
+   FileWriter mFile;
+   Text mPath;
+
+   // Batch that is being filled by the ontology                        
+   ::std::vector<Byte> mPending;
+   // Batch that is being written by the flusher                        
+   ::std::vector<Byte> mFlushing;
+
+   ::std::mutex mMutex;
+   ::std::condition_variable mWake;
+   ::std::thread mFlusher;
+   bool mRunning = false;
+   bool mFlushRequested = false;
+
+   // How often pending records are written to the file                 
+   Clock::duration mInterval = ::std::chrono::milliseconds(5);
+   // Bytes in the file, including the ones still pending               
+   Size mSize = 0;
+
+   void Append(const JournalRecord&, const Byte*);
+   void FlusherLoop();
+   void WritePending();
+
+public:
+   Journal() = default;
+   Journal(const Journal&) = delete;
+   ~Journal();
+
+   bool Open(const Text&, Count baseIdeas, ::std::uint64_t generation);
+   void Close();
+   void Commit();
+
+   void LogCreate(Offset, const Bytes&);
+   void LogLink(Offset, Offset, JournalRecord::Type);
+   void LogDestroy(Offset);
+
+   auto GetSize() const noexcept -> Size;
+   auto GetPath() const noexcept -> const Text&;
+   bool IsOpen() const noexcept;
+   void SetInterval(Clock::duration) noexcept;
+};
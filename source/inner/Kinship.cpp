@@ -0,0 +1,191 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Kinship.hpp"
+#include "Ontology.hpp"
+#include <algorithm>
+#include <limits>
+
+
+/// Scramble a hash - the finalizer of SplitMix64                             
+///   @param x - the hash to scramble                                         
+///   @return the scrambled hash                                              
+static constexpr auto Mix(::std::uint64_t x) noexcept -> ::std::uint64_t {
+   x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+   x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+   return x ^ (x >> 31);
+}
+
+/// Fold the ideas an ontology learned since it was last signed into its      
+/// signature. Ontologies are signed the first time they are seen, and        
+/// signed over from scratch if they forgot ideas in the meantime (which      
+/// moves other ideas to their indices), or if they were produced at the      
+/// address of a destroyed ontology                                           
+///   @param ontology - the ontology to sign                                  
+void Kinship::Sign(const Ontology& ontology) {
+   const auto found = mIndexOf.FindIt(&ontology);
+   Offset index;
+   if (found)
+      index = found.GetValue();
+   else {
+      index = mMembers.size();
+      mIndexOf.Insert(&ontology, index);
+      mMembers.push_back({&ontology, ontology.GetSerial(), ontology.GetForgetCount(), {}, 0});
+      mMembers.back().mSignature.fill(::std::numeric_limits<::std::uint64_t>::max());
+   }
+
+   auto& member = mMembers[index];
+   const auto count = ontology.GetIdeaCount();
+   if (member.mForgets != ontology.GetForgetCount()
+   or member.mSerial != ontology.GetSerial()) {
+      member.mSerial = ontology.GetSerial();
+      member.mForgets = ontology.GetForgetCount();
+      member.mSignature.fill(::std::numeric_limits<::std::uint64_t>::max());
+      member.mSigned = 0;
+   }
+
+   // Each of the hash functions is the descriptor hash, offset by a    
+   // different odd constant and scrambled                              
+   for (Offset i = member.mSigned; i < count; ++i) {
+      const auto hash = ontology.GetIdeaHash(i);
+      for (Offset k = 0; k < Hashes; ++k) {
+         const auto h = Mix(hash + (k + 1) * 0x9E3779B97F4A7C15ull);
+         if (h < member.mSignature[k])
+            member.mSignature[k] = h;
+      }
+   }
+
+   member.mSigned = count;
+}
+
+/// Forget an ontology, for example when its mind is destroyed                
+///   @param ontology - the ontology to forget                                
+void Kinship::Forget(const Ontology& ontology) {
+   const auto found = mIndexOf.FindIt(&ontology);
+   if (not found)
+      return;
+
+   // Swap the last member in place of the forgotten one                
+   const auto index = found.GetValue();
+   mIndexOf.RemoveKey(&ontology);
+   if (index + 1 != mMembers.size()) {
+      mMembers[index] = mMembers.back();
+      mIndexOf[mMembers[index].mOntology] = index;
+   }
+   mMembers.pop_back();
+}
+
+/// Forget all ontologies                                                     
+void Kinship::Reset() {
+   mMembers.clear();
+   mIndexOf.Reset();
+   mBands.clear();
+   mParent.clear();
+}
+
+/// Get the signature of an ontology                                          
+///   @param ontology - the ontology                                          
+///   @return the signature, or nullptr if ontology was never signed          
+auto Kinship::GetSignature(const Ontology& ontology) const -> const Signature* {
+   const auto found = mIndexOf.FindIt(&ontology);
+   return found ? &mMembers[found.GetValue()].mSignature : nullptr;
+}
+
+/// Estimate the similarity of the vocabulary of two signed ontologies        
+///   @param a - the first ontology                                           
+///   @param b - the second ontology                                          
+///   @return the estimated Jaccard similarity in the range [0; 1], or zero   
+///      if any of the ontologies was never signed                            
+auto Kinship::Similarity(const Ontology& a, const Ontology& b) const -> Real {
+   const auto sa = GetSignature(a);
+   const auto sb = GetSignature(b);
+   return sa and sb ? Similarity(*sa, *sb) : Real {0};
+}
+
+/// Estimate the similarity of two signatures                                 
+///   @param a - the first signature                                          
+///   @param b - the second signature                                         
+///   @return the estimated Jaccard similarity in the range [0; 1]            
+auto Kinship::Similarity(const Signature& a, const Signature& b) noexcept -> Real {
+   Count equal = 0;
+   for (Offset k = 0; k < Hashes; ++k)
+      equal += a[k] == b[k];
+   return static_cast<Real>(equal) / static_cast<Real>(Hashes);
+}
+
+/// Gather groups of ontologies with a lot of vocabulary in common            
+/// Ontologies sharing a band are candidates, and candidates with enough      
+/// estimated similarity are joined into the same group                       
+///   @param threshold - the minimum estimated similarity of kin              
+///   @param minimum - the minimum number of ontologies in a group            
+///   @return the groups, each in order of signing                            
+auto Kinship::Gather(Real threshold, Count minimum) const -> ::std::vector<Group> {
+   // Hash each band of each signature, and sort members by it, so that 
+   // members sharing a band end up next to each other                  
+   mBands.clear();
+   mBands.reserve(mMembers.size() * Bands);
+   for (Offset i = 0; i < mMembers.size(); ++i) {
+      const auto& signature = mMembers[i].mSignature;
+      if (not mMembers[i].mSigned)
+         continue;
+
+      for (Offset b = 0; b < Bands; ++b) {
+         ::std::uint64_t key = Mix(b + 1);
+         for (Offset r = 0; r < Rows; ++r)
+            key = Mix(key ^ signature[b * Rows + r]);
+         mBands.emplace_back(key, i);
+      }
+   }
+   ::std::sort(mBands.begin(), mBands.end());
+
+   mParent.resize(mMembers.size());
+   for (Offset i = 0; i < mParent.size(); ++i)
+      mParent[i] = i;
+
+   const auto root = [this](Offset i) {
+      while (mParent[i] != i)
+         i = mParent[i] = mParent[mParent[i]];
+      return i;
+   };
+
+   // Verify each candidate against the first member of its bucket only,
+   // so that large buckets don't make this quadratic again             
+   for (Offset begin = 0; begin < mBands.size();) {
+      auto end = begin + 1;
+      while (end < mBands.size() and mBands[end].first == mBands[begin].first)
+         ++end;
+
+      const auto first = mBands[begin].second;
+      for (auto i = begin + 1; i < end; ++i) {
+         const auto other = mBands[i].second;
+         const auto a = root(first);
+         const auto b = root(other);
+         if (a != b and Similarity(mMembers[first].mSignature,
+                                   mMembers[other].mSignature) >= threshold)
+            mParent[b] = a;
+      }
+
+      begin = end;
+   }
+
+   // Collect groups in order of first appearance                       
+   ::std::vector<Group> groups;
+   ::std::vector<Offset> groupOf(mMembers.size(), mMembers.size());
+   for (Offset i = 0; i < mMembers.size(); ++i) {
+      const auto r = root(i);
+      if (groupOf[r] == mMembers.size()) {
+         groupOf[r] = groups.size();
+         groups.emplace_back();
+      }
+      groups[groupOf[r]].push_back(mMembers[i].mOntology);
+   }
+
+   ::std::erase_if(groups, [minimum](const Group& group) {
+      return group.size() < ::std::max<Count>(minimum, 2);
+   });
+   return groups;
+}
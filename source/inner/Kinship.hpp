@@ -0,0 +1,80 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct Ontology;
+
+
+///                                                                           
+///   Kinship between ontologies                                              
+///                                                                           
+/// Estimates how much vocabulary ontologies have in common, without ever     
+/// comparing them pairwise. Each ontology is summarized by a MinHash         
+/// signature of the descriptors of its ideas - the fraction of equal         
+/// minimums in two signatures estimates the Jaccard similarity of the two    
+/// idea sets. Signatures are only ever updated with newly learned ideas.     
+///                                                                           
+/// Signatures are split into bands, and ontologies that have a band in       
+/// common become candidates for kinship (locality-sensitive hashing). Only   
+/// candidates are compared, so grouping is roughly linear in the number of   
+/// ontologies, instead of quadratic.                                         
+///                                                                           
+struct Kinship {
+   static constexpr Count Bands = 16;
+   static constexpr Count Rows = 4;
+   static constexpr Count Hashes = Bands * Rows;
+   using Signature = ::std::array<::std::uint64_t, Hashes>;
+
+   /// A group of related ontologies                                          
+   using Group = ::std::vector<const Ontology*>;
+
+private:
+   struct Member {
+      const Ontology* mOntology;
+      ::std::uint64_t mSerial;
+      // Number of ideas the ontology had forgotten when last signed    
+      ::std::uint64_t mForgets;
+      Signature mSignature;
+      // Number of ideas folded into the signature so far               
+      Count mSigned = 0;
+   };
+
+   ::std::vector<Member> mMembers;
+   TUnorderedMap<const Ontology*, Offset> mIndexOf;
+
+   // Reused between groupings - band keys of all members, and the      
+   // union-find forest over them                                       
+   mutable ::std::vector<::std::pair<::std::uint64_t, Offset>> mBands;
+   mutable ::std::vector<Offset> mParent;
+
+public:
+   void Sign(const Ontology&);
+   void Forget(const Ontology&);
+   void Reset();
+
+   /// Forget all ontologies that satisfy a condition                         
+   ///   @param condition - function that takes a const Ontology* and         
+   ///      returns true if the ontology should be forgotten                  
+   template<class F>
+   void ForgetIf(F&& condition) {
+      for (Offset i = mMembers.size(); i > 0; --i) {
+         if (condition(mMembers[i - 1].mOntology))
+            Forget(*mMembers[i - 1].mOntology);
+      }
+   }
+
+   auto GetSignature(const Ontology&) const -> const Signature*;
+   auto Similarity(const Ontology&, const Ontology&) const -> Real;
+   auto Gather(Real threshold, Count minimum) const -> ::std::vector<Group>;
+
+   static auto Similarity(const Signature&, const Signature&) noexcept -> Real;
+};
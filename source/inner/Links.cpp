@@ -0,0 +1,106 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Links.hpp"
+
+
+/// Start with an empty version, visible in any epoch                         
+Links::Links()
+   : mHead {::std::make_shared<Version>()} {}
+
+/// Get the links as they were in an epoch                                    
+///   @param epoch - the epoch of the reader's view                           
+///   @return the newest version that isn't newer than the epoch              
+auto Links::Read(Epoch epoch) const -> View {
+   ::std::shared_ptr<const Version> version = mHead.load();
+   while (version->mEpoch > epoch) {
+      auto previous = version->mPrevious.load();
+      if (not previous)
+         break;
+      version = ::std::move(previous);
+   }
+   return {::std::move(version)};
+}
+
+/// Get the latest version of the links, including unpublished ones           
+///   @attention only the writer should use this                              
+///   @return the latest version                                              
+auto Links::Latest() const -> View {
+   return {mHead.load()};
+}
+
+/// Link an idea, unless already linked                                       
+///   @attention only a single writer can append at a time                    
+///   @param idea - the idea to link                                          
+///   @param writing - the epoch being written                                
+///   @param oldest - the oldest epoch any reader might still be viewing      
+///   @return true if the idea was linked                                     
+bool Links::Append(Idea* idea, Epoch writing, Epoch oldest) {
+   auto head = mHead.load();
+   if (head->mIdeas.Contains(idea))
+      return false;
+
+   if (head->mEpoch == writing) {
+      // Nobody can see the epoch being written, so there's no need to  
+      // copy the links again                                           
+      head->mIdeas << idea;
+      return true;
+   }
+
+   auto fresh = ::std::make_shared<Version>();
+   fresh->mEpoch = writing;
+   fresh->mIdeas.Reserve(head->mIdeas.GetCount() + 1);
+   for (auto other : head->mIdeas)
+      fresh->mIdeas << other;
+   fresh->mIdeas << idea;
+
+   // Readers that might need anything older than the current head are  
+   // gone, so the rest of the versions can be reclaimed                
+   if (head->mEpoch <= oldest)
+      head->mPrevious.store(nullptr);
+   fresh->mPrevious.store(head);
+   mHead.store(::std::move(fresh));
+   return true;
+}
+
+/// Unlink an idea, if linked                                                 
+///   @attention only a single writer can remove at a time                    
+///   @param idea - the idea to unlink                                        
+///   @param writing - the epoch being written                                
+///   @param oldest - the oldest epoch any reader might still be viewing      
+///   @return true if the idea was unlinked                                   
+bool Links::Remove(const Idea* idea, Epoch writing, Epoch oldest) {
+   auto head = mHead.load();
+   if (not head->mIdeas.Contains(const_cast<Idea*>(idea)))
+      return false;
+
+   Ideas kept;
+   kept.Reserve(head->mIdeas.GetCount() - 1);
+   for (auto other : head->mIdeas) {
+      if (other != idea)
+         kept << other;
+   }
+
+   if (head->mEpoch == writing) {
+      head->mIdeas = Abandon(kept);
+      return true;
+   }
+
+   auto fresh = ::std::make_shared<Version>();
+   fresh->mEpoch = writing;
+   fresh->mIdeas = Abandon(kept);
+   if (head->mEpoch <= oldest)
+      head->mPrevious.store(nullptr);
+   fresh->mPrevious.store(head);
+   mHead.store(::std::move(fresh));
+   return true;
+}
+
+/// Forget all links, in all versions                                         
+void Links::Reset() {
+   mHead.store(::std::make_shared<Version>());
+}
@@ -0,0 +1,63 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+struct Idea;
+
+using Ideas = TMany<Idea*>;
+
+// Version of an ontology - everything learned while writing belongs to 
+// the next epoch, which becomes visible to readers once it's published 
+using Epoch = ::std::uint64_t;
+
+
+///                                                                           
+///   Multiversioned list of links to other ideas                             
+///                                                                           
+/// Links are copied on write. Every version is stamped with the epoch it     
+/// was written in, and keeps the previous version around for as long as      
+/// some reader might still need it. Readers pick the newest version that     
+/// is not newer than their view, and keep walking it, while the writer       
+/// keeps linking ideas. The latest version is swapped in atomically.         
+///                                                                           
+struct Links {
+   struct Version {
+      Ideas mIdeas;
+      Epoch mEpoch = 0;
+      ::std::atomic<::std::shared_ptr<const Version>> mPrevious;
+   };
+
+   /// A version of the links, kept alive while being walked                  
+   struct View {
+      ::std::shared_ptr<const Version> mVersion;
+
+      auto begin() const { return mVersion->mIdeas.begin(); }
+      auto end() const { return mVersion->mIdeas.end(); }
+      auto GetCount() const -> Count { return mVersion->mIdeas.GetCount(); }
+      bool Contains(const Idea* idea) const {
+         return mVersion->mIdeas.Contains(const_cast<Idea*>(idea));
+      }
+   };
+
+private:
+   ::std::atomic<::std::shared_ptr<Version>> mHead;
+
+public:
+   Links();
+   Links(const Links&) = delete;
+
+   auto Read(Epoch) const -> View;
+   auto Latest() const -> View;
+   bool Append(Idea*, Epoch writing, Epoch oldest);
+   bool Remove(const Idea*, Epoch writing, Epoch oldest);
+   void Reset();
+};
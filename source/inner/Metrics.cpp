@@ -0,0 +1,132 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Metrics.hpp"
+#include <bit>
+#include <deque>
+#include <mutex>
+
+
+/// Get a counter                                                             
+///   @param counter - the counter                                            
+///   @return the value                                                       
+auto Metrics::Snapshot::Get(Counter counter) const noexcept -> ::std::uint64_t {
+   return mCounters[counter];
+}
+
+/// Get the number of values recorded in a histogram                          
+///   @param histogram - the histogram                                        
+///   @return the number of values                                            
+auto Metrics::Snapshot::Samples(Histogram histogram) const noexcept -> ::std::uint64_t {
+   ::std::uint64_t result = 0;
+   for (auto count : mHistograms[histogram])
+      result += count;
+   return result;
+}
+
+/// Estimate a percentile of a histogram                                      
+///   @param histogram - the histogram                                        
+///   @param percentile - the percentile in the range [0; 1]                  
+///   @return the upper bound of the bucket the percentile falls in, or zero  
+///      if nothing was recorded                                              
+auto Metrics::Snapshot::Percentile(Histogram histogram, Real percentile) const noexcept
+-> ::std::uint64_t {
+   const auto total = Samples(histogram);
+   if (not total)
+      return 0;
+
+   const auto wanted = static_cast<::std::uint64_t>(percentile * static_cast<Real>(total));
+   ::std::uint64_t seen = 0;
+   for (Offset b = 0; b < Buckets; ++b) {
+      seen += mHistograms[histogram][b];
+      if (seen > wanted or seen == total)
+         return b ? (::std::uint64_t {1} << b) - 1 : 0;
+   }
+   return ~::std::uint64_t {0};
+}
+
+/// Get the ratio of two counters                                             
+///   @param total - the counter of all attempts                              
+///   @param hits - the counter of successful attempts                        
+///   @return the ratio in the range [0; 1], or zero if there were no attempts
+auto Metrics::Snapshot::HitRate(Counter total, Counter hits) const noexcept -> Real {
+   return mCounters[total]
+      ? static_cast<Real>(mCounters[hits]) / static_cast<Real>(mCounters[total])
+      : Real {0};
+}
+
+#if LANGULUS_MOD_AI_METRICS
+
+namespace
+{
+   /// Metrics of a single thread - only the owning thread writes them,       
+   /// so they are incremented without read-modify-write atomics              
+   struct Shard {
+      ::std::array<::std::atomic<::std::uint64_t>, Metrics::CounterCount> mCounters {};
+      ::std::array<::std::array<::std::atomic<::std::uint64_t>, Metrics::Buckets>,
+         Metrics::HistogramCount> mHistograms {};
+   };
+
+   /// All shards ever created. Shards outlive their threads, so that         
+   /// nothing recorded is lost, and are never moved                          
+   struct Registry {
+      ::std::mutex mMutex;
+      ::std::deque<Shard> mShards;
+   };
+
+   auto GetRegistry() -> Registry& {
+      static Registry registry;
+      return registry;
+   }
+
+   /// Get the shard of the current thread, registering it the first time     
+   auto GetShard() -> Shard& {
+      thread_local Shard* shard = [] {
+         auto& registry = GetRegistry();
+         const ::std::lock_guard lock {registry.mMutex};
+         return &registry.mShards.emplace_back();
+      }();
+      return *shard;
+   }
+
+   /// Increment a value that only the current thread writes                  
+   void Bump(::std::atomic<::std::uint64_t>& value, ::std::uint64_t amount) noexcept {
+      value.store(value.load(::std::memory_order_relaxed) + amount, ::std::memory_order_relaxed);
+   }
+}
+
+/// Increment a counter                                                       
+///   @param counter - the counter                                            
+///   @param amount - the amount to add                                       
+void Metrics::Add(Counter counter, ::std::uint64_t amount) noexcept {
+   Bump(GetShard().mCounters[counter], amount);
+}
+
+/// Record a value in a histogram                                             
+///   @param histogram - the histogram                                        
+///   @param value - the value                                                
+void Metrics::Record(Histogram histogram, ::std::uint64_t value) noexcept {
+   const auto bucket = static_cast<Offset>(::std::bit_width(value));
+   Bump(GetShard().mHistograms[histogram][bucket < Buckets ? bucket : Buckets - 1], 1);
+}
+
+/// Sum the metrics of all threads                                            
+///   @param snapshot - [in/out] the snapshot to add to                       
+void Metrics::Collect(Snapshot& snapshot) {
+   auto& registry = GetRegistry();
+   const ::std::lock_guard lock {registry.mMutex};
+   for (auto& shard : registry.mShards) {
+      for (Offset c = 0; c < CounterCount; ++c)
+         snapshot.mCounters[c] += shard.mCounters[c].load(::std::memory_order_relaxed);
+      for (Offset h = 0; h < HistogramCount; ++h) {
+         for (Offset b = 0; b < Buckets; ++b)
+            snapshot.mHistograms[h][b] += shard.mHistograms[h][b].load(::std::memory_order_relaxed);
+      }
+   }
+}
+
+#endif
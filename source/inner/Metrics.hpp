@@ -0,0 +1,95 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+///                                                                           
+///   Metrics of the AI module                                                
+///                                                                           
+/// Counters and histograms, recorded without locking - each thread has its   
+/// own set, that only it writes to, and polling sums all sets together.      
+/// Histograms have a bucket for each power of two, so recording a value is   
+/// a single increment, too. Metrics are compiled out entirely, unless the    
+/// module is built with LANGULUS_MOD_AI_METRICS.                             
+///                                                                           
+struct Metrics {
+   enum Counter : ::std::uint8_t {
+      // Texts interpreted, and how many of them were cached            
+      Interpretations,
+      InterpretCacheHits,
+      // Interpretations compiled, and how many of them were cached     
+      Compilations,
+      CompileCacheHits,
+      // Ontology mutations                                             
+      IdeasCreated,
+      LinksAdded,
+      CounterCount
+   };
+
+   enum Histogram : ::std::uint8_t {
+      // Nanoseconds it took to interpret and compile a text            
+      InterpretLatency,
+      // Graph nodes visited per advanced Equal, and per Extract        
+      EqualVisits,
+      ExtractVisits,
+      HistogramCount
+   };
+
+   static constexpr Count Buckets = 64;
+
+   /// Metrics summed over all threads                                        
+   struct Snapshot {
+      ::std::array<::std::uint64_t, CounterCount> mCounters {};
+      ::std::array<::std::array<::std::uint64_t, Buckets>, HistogramCount> mHistograms {};
+      // Events remembered verbatim by all minds, and their summaries   
+      Count mHistoryEvents = 0;
+      Count mHistorySummaries = 0;
+
+      auto Get(Counter) const noexcept -> ::std::uint64_t;
+      auto Samples(Histogram) const noexcept -> ::std::uint64_t;
+      auto Percentile(Histogram, Real) const noexcept -> ::std::uint64_t;
+      auto HitRate(Counter total, Counter hits) const noexcept -> Real;
+   };
+
+#if LANGULUS_MOD_AI_METRICS
+   static void Add(Counter, ::std::uint64_t = 1) noexcept;
+   static void Record(Histogram, ::std::uint64_t) noexcept;
+   static void Collect(Snapshot&);
+
+   /// Records the time until it goes out of scope into a histogram           
+   struct Timer {
+   private:
+      Histogram mHistogram;
+      ::std::chrono::steady_clock::time_point mStart;
+
+   public:
+      Timer(Histogram histogram) noexcept
+         : mHistogram {histogram}
+         , mStart {::std::chrono::steady_clock::now()} {}
+
+      ~Timer() {
+         Record(mHistogram, static_cast<::std::uint64_t>(
+            ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+               ::std::chrono::steady_clock::now() - mStart).count()));
+      }
+   };
+#else
+   static void Add(Counter, ::std::uint64_t = 1) noexcept {}
+   static void Record(Histogram, ::std::uint64_t) noexcept {}
+   static void Collect(Snapshot&) {}
+
+   struct Timer {
+      Timer(Histogram) noexcept {}
+   };
+#endif
+};
@@ -1,32 +1,216 @@
 #include "Ontology.hpp"
+#include <algorithm>
 
 
 /// Default ontology constructor                                              
-Ontology::Ontology(const A::AIUnit& c) : mOwner {c} {}
+Ontology::Ontology(const A::AIUnit& c) : mOwner {&c} {}
 
 /// Ontology descriptor constructor                                           
 ///   @param d - descriptor                                                   
-Ontology::Ontology(const A::AIUnit& c, const Many&) : mOwner {c} {
+Ontology::Ontology(const A::AIUnit& c, const Many&) : mOwner {&c} {
    TODO();
 }
 
+/// Get a serial for a new ontology                                           
+///   @return the serial, unique for the lifetime of the process              
+auto Ontology::NextSerial() noexcept -> ::std::uint64_t {
+   static ::std::atomic<::std::uint64_t> serials = 0;
+   return ++serials;
+}
+
 /// Ideas have their own hierarchy and circular references, and need to be    
 /// teared down before we're able to reset them                               
 Text Ontology::Self() const {
-   return mOwner.Self();
+   return mOwner ? mOwner->Self() : Text {"Ontology: "};
 }
 
 /// Ideas have their own hierarchy and circular references, and need to be    
 /// teared down before we're able to reset them                               
 void Ontology::Teardown() {
+   mCompactor.Stop();
+   mJournal.Close();
+   mPager.Reset();
    mCache.Reset();
+   mShadows.Reset();
+   mShared.store(::std::make_shared<Layers>());
+   mLayered = false;
+   mOrder.Reset();
+   mRetired.clear();
    mIdeas.Teardown();
 }
 
+/// Called by each idea as it is produced, to give it an index, and to        
+/// record its creation in the journal                                        
+///   @param idea - the newly produced idea                                   
+void Ontology::Register(Idea& idea) {
+   idea.mIndex = mOrder.GetCount();
+   idea.mEpoch = Writing();
+   mOrder << &idea;
+   mDirty = true;
+   Metrics::Add(Metrics::IdeasCreated);
+
+   // Shadow the shared idea with the same descriptor, if any - this    
+   // happens while the factory is guarded                              
+   const auto base = FindShared(idea.mDescriptor);
+   idea.mBased = idea.mEpoch;
+   idea.mBase = base;
+   if (base)
+      mShadows.Insert(base, &idea);
+
+   Bytes blob;
+   if (mJournal.IsOpen() and Encode(idea, nullptr, blob))
+      mJournal.LogCreate(idea.mIndex, blob);
+}
+
+/// Remove an idea from the creation order, by moving the last idea in its    
+/// place - journals do the same when replayed, so indices stay in sync       
+///   @param idea - the idea to remove                                        
+void Ontology::Unregister(Idea& idea) {
+   mDirty = true;
+   const auto last = mOrder.Last();
+   mOrder[idea.mIndex] = last;
+   last->mIndex = idea.mIndex;
+   mOrder.RemoveIndex(mOrder.GetCount() - 1);
+   ++mForgets;
+
+   if (const auto base = idea.mBase.load())
+      mShadows.RemoveKey(base);
+}
+
+/// Forget an idea - it is unlinked from all other ideas, and destroyed       
+///   @param idea - the idea to forget                                        
+void Ontology::Forget(Idea* idea) {
+   if (mPager.IsActive()) {
+      // Partitions are images on disk - the idea would just come back  
+      // the next time its partition is paged in                        
+      Logger::Error(Self(), "Can't forget ", *idea, " in a paged ontology");
+      return;
+   }
+
+   mJournal.LogDestroy(idea->mIndex);
+
+   // Links are symmetric, so only the ideas linked to this one need to 
+   // be unlinked from it                                               
+   for (auto other : idea->mAssociations.Latest()) {
+      if (other != idea)
+         RemoveLink(other->mAssociations, idea);
+   }
+   for (auto other : idea->mDisassociations.Latest()) {
+      if (other != idea)
+         RemoveLink(other->mDisassociations, idea);
+   }
+
+   Unregister(*idea);
+   mCache.Clear();
+   Retire(idea);
+}
+
+/// Hide an idea from readers that begin viewing the ontology after the epoch 
+/// being written, and destroy it once all older readers are done with it     
+///   @param idea - the idea to retire, already unregistered                  
+void Ontology::Retire(Idea* idea) {
+   idea->mForgotten = Writing();
+   mDirty = true;
+   mRetired.emplace_back(idea->mForgotten, idea);
+}
+
+/// Learn a retired idea again, before it was destroyed - it is still in the  
+/// factory, so it is brought back instead, but without anything it knew.     
+/// Readers that still saw it before it was retired lose sight of it, until   
+/// the epoch it is learned again in                                          
+///   @param idea - the retired idea                                          
+void Ontology::Revive(Idea* idea) {
+   ::std::erase_if(mRetired, [idea](const auto& retired) {
+      return retired.second == idea;
+   });
+
+   for (auto links : {&idea->mAssociations, &idea->mDisassociations}) {
+      Ideas linked;
+      for (auto other : links->Latest())
+         linked << other;
+      for (auto other : linked)
+         RemoveLink(*links, other);
+   }
+
+   idea->mForgotten = Idea::Remembered;
+   const ::std::lock_guard lock {mFactoryGuard};
+   Register(*idea);
+}
+
+/// Destroy retired ideas that no reader can see anymore                      
+void Ontology::Reclaim() {
+   if (mRetired.empty())
+      return;
+
+   const auto oldest = OldestView();
+   ::std::erase_if(mRetired, [&](const auto& retired) {
+      if (oldest < retired.first)
+         return false;
+
+      retired.second->Teardown();
+      Destroy(retired.second);
+      return true;
+   });
+}
+
+/// Called by ideas whenever they get (dis)associated, to record the link     
+/// in the journal, and to pin paged ideas                                    
+///   @param from - the idea that was linked                                  
+///   @param to - the idea it was linked to                                   
+///   @param associate - true if associated, false if disassociated           
+void Ontology::Linked(const Idea& from, const Idea& to, bool associate) {
+   if (mPager.IsActive()) {
+      // Modified partitions can't be evicted without losing knowledge  
+      mPager.Pin(&from);
+      mPager.Pin(&to);
+   }
+
+   mJournal.LogLink(from.mIndex, to.mIndex, associate
+      ? JournalRecord::Associate : JournalRecord::Disassociate);
+}
+
+/// Housekeeping, called once per update of the owner - starts compacting the 
+/// journal in the background when it grows too big, and evicts cold          
+/// partitions of a paged ontology                                            
+void Ontology::Update() {
+   if (mJournal.IsOpen() and mJournal.GetSize() > mCompactThreshold
+   and not mCompacting)
+      CompactLater();
+   if (mPager.IsActive())
+      Evict();
+   Reclaim();
+}
+
 /// Create/destroy ideas through a verb                                       
+/// Ideas are never created through the factory directly - they're produced   
+/// like anywhere else, so that retired ideas are revived instead of handed   
+/// back, and paged ideas are faulted in instead of duplicated                
 ///   @param verb - the verb                                                  
 void Ontology::Create(Verb& verb) {
-   mIdeas.Create(this, verb);
+   if (verb.GetMass() < 0) {
+      // Forgotten ideas have to be unlinked and journaled, so they     
+      // can't be left to the factory                                   
+      verb.ForEachDeep([&](const Construct& construct) {
+         if (construct.GetType() != MetaDataOf<Idea>())
+            return;
+
+         if (auto idea = Find(construct.GetDescriptor())) {
+            Forget(idea);
+            verb.Done();
+         }
+      });
+      return;
+   }
+
+   verb.ForEachDeep([&](const Construct& construct) {
+      if (construct.GetType() != MetaDataOf<Idea>())
+         return;
+
+      if (auto idea = Produce(construct.GetDescriptor())) {
+         verb << idea;
+         verb.Done();
+      }
+   });
 }
 
 /// Select is isomorphic to create when positive                              
@@ -43,6 +227,7 @@ void Ontology::Select(Verb& verb) {
 ///      the database denser and smaller. But it costs more time...           
 ///   @return the idea representing the data                                  
 auto Ontology::Build(const Many& data, bool /*findMetapatterns*/) -> Idea* {
+   AI_TRACE("Ontology::Build");
    // Clear the cache every time we build a new pattern                 
    mCache.Clear();
 
@@ -96,9 +281,9 @@ auto Ontology::Build(const Many& data, bool /*findMetapatterns*/) -> Idea* {
    }
    else {
       // Anything else gets normalized conventionally using Neat        
-      return mIdeas.CreateOne(this, data);
+      return Produce(data);
    }
-   
+
    // Combine all the generated ideas into one and return               
    if (coalesced) {
       if (coalesced.GetCount() == 1)
@@ -117,7 +302,7 @@ auto Ontology::Build(const Many& data, bool /*findMetapatterns*/) -> Idea* {
       }*/
 
       // Build an idea from the flat idea sequence                      
-      return mIdeas.CreateOne(this, coalesced);
+      return Produce(coalesced);
    }
 
    // If reached, then no idea was built (empty data?)                  
@@ -140,14 +325,14 @@ auto Ontology::BuildText(const Text& text) -> Idea* {
       // Create two ideas and associate them                            
       // We can't afford to lose the original information, but we also  
       // want to be able to find loose matches                          
-      auto i1 = mIdeas.CreateOne(this, text);
-      auto i2 = mIdeas.CreateOne(this, lower);
+      auto i1 = Produce(text);
+      auto i2 = Produce(lower);
       i1->Associate(i2);
       return i1;
    }
 
    // Text is already sanitized, just return its idea                   
-   return mIdeas.CreateOne(this, text);
+   return Produce(text);
 }
 
 /// Optimize a sequence, extracting sequential entries of the given type and  
@@ -165,9 +350,9 @@ void Ontology::OptimizeFor(Many& data) const {
 
    data.template ForEachDeep<false, false>([&concatenated](Many& group) {
       if (group.IsOr())
-         return Loop::Break;     // Abort on groups that branch         
+         return Loop::Break;     // Abort on groups that branch
       else if (group.IsDeep())
-         return Loop::Continue;  // Just continue on otherwise deep     
+         return Loop::Continue;  // Just continue on otherwise deep
 
       if (group.template IsSimilar<FOR>()) {
          // Consume any sequential data (even if deep)                  
@@ -181,7 +366,7 @@ void Ontology::OptimizeFor(Many& data) const {
 
    if constexpr (CT::Text<FOR>) {
       // Interpret the concatenated text again                          
-      auto idea = mIdeas.Find(concatenated);
+      auto idea = Find(concatenated);
       if (idea) {
          data >> idea;
          return;
@@ -194,6 +379,572 @@ void Ontology::OptimizeFor(Many& data) const {
       data = Abandon(concatenated);
 }
 
+/// Layer the ontology over a shared one, such as a society's - ideas that    
+/// aren't known locally are looked up there. Sharing the same ontology       
+/// again only shadows the ideas it learned since                             
+///   @attention the shared ontology must outlive this one, or be unshared    
+///   @param shared - the ontology to layer over                              
+void Ontology::Share(const Ontology& shared) {
+   if (&shared == this)
+      return;
+
+   if (not IsSharing(&shared)) {
+      auto layers = GetLayers()->mOntologies;
+      layers.push_back(&shared);
+      SetLayers(::std::move(layers));
+   }
+
+   // Ideas that are already known locally begin shadowing shared ones  
+   // in the epoch being written                                        
+   const ::std::lock_guard lock {mFactoryGuard};
+   for (auto idea : mOrder) {
+      if (idea->mBase.load())
+         continue;
+
+      const auto base = shared.Find(idea->mDescriptor);
+      if (not base)
+         continue;
+
+      idea->mBased = Writing();
+      idea->mBase = base;
+      mShadows.Insert(base, idea);
+      mDirty = true;
+   }
+   mCache.Clear();
+}
+
+/// Stop layering the ontology over a shared one                              
+/// Local ideas that shadowed its ideas lose what they inherited from them    
+///   @attention no reader may be viewing the ontology, as the shared one is  
+///      usually destroyed right after                                        
+///   @param shared - the ontology to stop layering over                      
+void Ontology::Unshare(const Ontology& shared) {
+   auto layers = GetLayers()->mOntologies;
+   const auto found = ::std::find(layers.begin(), layers.end(), &shared);
+   if (found == layers.end())
+      return;
+
+   layers.erase(found);
+   SetLayers(::std::move(layers));
+   mCache.Clear();
+
+   const ::std::lock_guard lock {mFactoryGuard};
+   for (auto idea : mOrder) {
+      const auto base = idea->mBase.load();
+      if (base and base->GetOntology() == &shared) {
+         mShadows.RemoveKey(base);
+         idea->mBase = nullptr;
+      }
+   }
+}
+
+/// Get the shared layers, as seen by the current thread                      
+///   @return the newest layers that aren't newer than the thread's view      
+auto Ontology::GetLayers() const -> ::std::shared_ptr<const Layers> {
+   const auto epoch = GetEpoch();
+   ::std::shared_ptr<const Layers> layers = mShared.load();
+   while (layers->mEpoch > epoch) {
+      auto previous = layers->mPrevious.load();
+      if (not previous)
+         break;
+      layers = ::std::move(previous);
+   }
+   return layers;
+}
+
+/// Replace the shared layers in the epoch being written - readers with       
+/// older views keep the layers they've been seeing                           
+///   @param ontologies - the new layers, in order of lookup                  
+void Ontology::SetLayers(::std::vector<const Ontology*>&& ontologies) {
+   auto head = mShared.load();
+   auto fresh = ::std::make_shared<Layers>();
+   fresh->mOntologies = ::std::move(ontologies);
+   fresh->mEpoch = Writing();
+
+   // Nobody can see the epoch being written, so a head written in it   
+   // is replaced, and older versions are dropped once nobody sees them 
+   if (head->mEpoch == fresh->mEpoch)
+      fresh->mPrevious.store(head->mPrevious.load());
+   else {
+      if (head->mEpoch <= OldestView())
+         head->mPrevious.store(nullptr);
+      fresh->mPrevious.store(head);
+   }
+
+   if (not fresh->mOntologies.empty())
+      mLayered = true;
+   mShared.store(::std::move(fresh));
+   mDirty = true;
+}
+
+/// Learn the ideas that many other ontologies know, such as the private      
+/// ontologies of a society's members, along with whatever they know about    
+/// how those ideas are linked. Ideas that the others already inherit from    
+/// this ontology aren't counted                                              
+///   @attention the other ontologies must not be written meanwhile           
+///   @param others - the ontologies to learn from                            
+///   @param quorum - how many of them must know an idea for it to be learned 
+///   @return the number of ideas learned                                     
+auto Ontology::Adopt(const ::std::vector<const Ontology*>& others, Count quorum) -> Count {
+   const auto inherited = [this](const Idea* idea) {
+      const auto base = idea->mBase.load();
+      return base and base->GetOntology() == this;
+   };
+
+   // Ontologies know each descriptor only once, so counting their      
+   // hashes counts the ontologies that know them                       
+   TUnorderedMap<::std::uint64_t, Count> known;
+   for (auto other : others) {
+      for (Offset i = 0; i < other->GetIdeaCount(); ++i) {
+         if (inherited(other->mOrder[i]))
+            continue;
+
+         const auto hash = other->GetIdeaHash(i);
+         if (known.ContainsKey(hash))
+            ++known[hash];
+         else
+            known.Insert(hash, 1);
+      }
+   }
+
+   // Transfer the ideas without gathering anything around them, so     
+   // that only links between adopted ideas are kept                    
+   const auto before = GetIdeaCount();
+   for (auto other : others) {
+      Ideas roots;
+      for (Offset i = 0; i < other->GetIdeaCount(); ++i) {
+         const auto idea = other->mOrder[i];
+         if (not inherited(idea) and known[other->GetIdeaHash(i)] >= quorum)
+            roots << idea;
+      }
+
+      if (roots)
+         Transfer(*other, roots, roots.GetCount());
+   }
+   return GetIdeaCount() - before;
+}
+
+/// Forget the local ideas that only repeat what the shared layers know -     
+/// shadows that didn't learn anything on top of the ideas they shadow.       
+/// Lookups fall through to the shared ideas instead. Persistent and paged    
+/// ontologies keep them, or they'd lose them once they stop sharing          
+///   @return the number of ideas forgotten                                   
+auto Ontology::Prune() -> Count {
+   if (mJournal.IsOpen() or mBasePath or mPager.IsActive())
+      return 0;
+
+   // Ideas that other ideas are made of must stay                      
+   IdeaSet parts;
+   for (auto idea : mOrder) {
+      if (not idea->mDescriptor.Is<Idea>())
+         continue;
+      idea->mDescriptor.ForEach([&](const Idea& part) {
+         parts << &part;
+      });
+   }
+
+   // A local link is repeated if the shared ideas are linked as well   
+   const auto repeats = [](const Idea* idea, const Idea* base, bool associations) {
+      const auto& links = associations ? idea->mAssociations : idea->mDisassociations;
+      for (auto other : links.Latest()) {
+         const auto shared = other == idea ? base : other->mBase.load();
+         if (not shared)
+            return false;
+
+         const auto linked = associations
+            ? base->HasAssociation(shared)
+            : base->HasDisassociation(shared);
+         if (not linked)
+            return false;
+      }
+      return true;
+   };
+
+   Ideas redundant;
+   for (auto idea : mOrder) {
+      const auto base = idea->mBase.load();
+      if (base and not parts.Contains(idea)
+      and repeats(idea, base, true) and repeats(idea, base, false))
+         redundant << idea;
+   }
+
+   for (auto idea : redundant)
+      Forget(idea);
+   return redundant.GetCount();
+}
+
+/// Check if the ontology is layered over another one, as seen by the         
+/// current thread                                                            
+///   @param ontology - the ontology to check                                 
+///   @return true if ontology is one of the shared layers                    
+bool Ontology::IsSharing(const Ontology* ontology) const {
+   if (not mLayered)
+      return false;
+
+   const auto layers = GetLayers();
+   return ::std::find(layers->mOntologies.begin(), layers->mOntologies.end(), ontology)
+      != layers->mOntologies.end();
+}
+
+/// Find an idea in the shared layers, as seen by the current thread          
+///   @param key - the descriptor of the idea                                 
+///   @return the shared idea if found, or nullptr                            
+auto Ontology::FindShared(const Many& key) const -> const Idea* {
+   if (not mLayered)
+      return nullptr;
+
+   for (auto shared : GetLayers()->mOntologies) {
+      if (auto idea = shared->Find(key))
+         return idea;
+   }
+   return nullptr;
+}
+
+/// Substitute a shared idea with its shadow, if there is one - shadows in    
+/// the layers in between come first, so that a shared idea two layers        
+/// down is substituted with whatever the nearest layer learned about it      
+///   @param idea - the idea to substitute                                    
+///   @return the shadow, or the idea itself                                  
+auto Ontology::Overlay(const Idea* idea) const -> const Idea* {
+   if (not mLayered or idea->GetOntology() == this)
+      return idea;
+
+   for (auto shared : GetLayers()->mOntologies) {
+      const auto overlaid = shared->Overlay(idea);
+      if (overlaid != idea) {
+         idea = overlaid;
+         break;
+      }
+   }
+
+   const ::std::lock_guard lock {mFactoryGuard};
+   const auto found = mShadows.FindIt(idea);
+   return found and found.GetValue()->mBased <= GetEpoch()
+      ? found.GetValue() : idea;
+}
+
+/// Get the local shadow of a shared idea, creating it if needed, so that     
+/// something can be learned about it without modifying the shared layer      
+/// Shadows of ideas made of other ideas are made of shadows, so that local   
+/// ideas never refer to shared ones                                          
+///   @param idea - the shared idea                                           
+///   @return the shadow                                                      
+auto Ontology::Shadow(const Idea* idea) -> Idea* {
+   if (not idea->mDescriptor.Is<Idea>())
+      return Produce(idea->mDescriptor);
+
+   Ideas parts;
+   if (idea->mDescriptor.IsOr())
+      parts.MakeOr();
+   idea->mDescriptor.ForEach([&](const Idea& part) {
+      parts << (part.GetOntology() == this ? &const_cast<Idea&>(part) : Shadow(&part));
+   });
+
+   // The shared idea is made of the shared parts, so it isn't found by 
+   // the descriptor when the shadow is registered                      
+   auto shadow = Produce(parts);
+   if (not shadow->mBase.load()) {
+      const auto epoch = Writing();
+      const ::std::lock_guard lock {mFactoryGuard};
+      shadow->mBased = epoch;
+      shadow->mBase = idea;
+      mShadows.Insert(idea, shadow);
+   }
+   return shadow;
+}
+
+/// Get the serial of the ontology - ontologies produced at the address of a  
+/// destroyed one have a different serial                                     
+///   @return the serial                                                      
+auto Ontology::GetSerial() const noexcept -> ::std::uint64_t {
+   return mSerial;
+}
+
+/// Get the number of ideas learned by this ontology, excluding shared ones   
+///   @return the number of ideas                                             
+auto Ontology::GetIdeaCount() const noexcept -> Count {
+   return mOrder.GetCount();
+}
+
+/// Get the number of ideas ever forgotten or paged out by this ontology.     
+/// Each one moves the last idea in its place, so ideas past a count that     
+/// was seen before aren't necessarily the ones learned since                 
+///   @return the number of ideas removed so far                              
+auto Ontology::GetForgetCount() const noexcept -> ::std::uint64_t {
+   return mForgets;
+}
+
+/// Get the hash of the descriptor of an idea - equal ideas in different      
+/// ontologies have the same hash                                             
+///   @param index - the index of the idea, in order of creation              
+///   @return the hash                                                        
+auto Ontology::GetIdeaHash(Offset index) const -> ::std::uint64_t {
+   return HashDescriptor(mOrder[index]->mDescriptor);
+}
+
+/// Hash a descriptor by its contents. Descriptors made of ideas are hashed   
+/// by what their parts describe, instead of where the parts are in memory,   
+/// so that they hash the same in any ontology, and in any process            
+///   @param descriptor - the descriptor to hash                              
+///   @return the hash                                                        
+auto Ontology::HashDescriptor(const Many& descriptor) -> ::std::uint64_t {
+   if (not descriptor.Is<Idea>())
+      return static_cast<::std::uint64_t>(Many {descriptor}.GetHash().mHash);
+
+   // FNV-1a over the hashes of the parts, seeded differently for       
+   // alternatives, so that (a, b) and (a or b) differ                  
+   ::std::uint64_t hash = descriptor.IsOr()
+      ? 0x84222325CBF29CE4ull : 0xCBF29CE484222325ull;
+   descriptor.ForEach([&](const Idea& part) {
+      hash ^= HashDescriptor(part.mDescriptor);
+      hash *= 0x100000001B3ull;
+   });
+   return hash;
+}
+
+/// Views of the current thread, innermost first - a thread might be          
+/// viewing several ontologies at once                                        
+thread_local const Ontology::View* tView = nullptr;
+
+/// Acquire a consistent read view of the ontology                            
+/// Any number of threads can interpret the ontology while viewing it, and    
+/// won't see anything learned after the view was acquired                    
+///   @return the view, that is released when destroyed                       
+auto Ontology::Read() const -> View {
+   return View {this};
+}
+
+/// Begin viewing the latest published version of an ontology                 
+///   @param ontology - the ontology to view                                  
+Ontology::View::View(const Ontology* ontology)
+   : mOntology {ontology}
+   , mOuter    {tView} {
+   const ::std::lock_guard lock {ontology->mReadersGuard};
+   mEpoch = ontology->mPublished;
+   ++ontology->mReaders[mEpoch];
+   tView = this;
+}
+
+/// Stop viewing the ontology, allowing old versions to be reclaimed          
+Ontology::View::~View() {
+   tView = mOuter;
+   const ::std::lock_guard lock {mOntology->mReadersGuard};
+   const auto found = mOntology->mReaders.find(mEpoch);
+   if (--found->second == 0)
+      mOntology->mReaders.erase(found);
+}
+
+/// Acquire the exclusive right to learn - everything learned is published    
+/// to new readers when the writer is released                                
+///   @return the writer, that publishes when destroyed                       
+auto Ontology::Write() -> Writer {
+   return Writer {this};
+}
+
+/// Begin writing to an ontology                                              
+///   @param ontology - the ontology to write to                              
+Ontology::Writer::Writer(Ontology* ontology)
+   : mOntology {ontology}
+   , mLock     {ontology->mWriter} {}
+
+/// Publish everything that was learned while writing                         
+Ontology::Writer::~Writer() {
+   mOntology->Publish();
+}
+
+/// Make everything learned so far visible to new readers, and continue       
+/// learning in a new epoch - the new version is published by a single store  
+/// Nothing happens if nothing was learned since the last time                
+void Ontology::Publish() {
+   if (not mDirty)
+      return;
+
+   const ::std::lock_guard lock {mReadersGuard};
+   mPublished = mWriting++;
+   mDirty = false;
+}
+
+/// Get the epoch, visible to the current thread                              
+///   @return the epoch of the thread's view of this ontology, or the epoch   
+///           being written, if the thread isn't viewing it                   
+auto Ontology::GetEpoch() const -> Epoch {
+   for (auto view = tView; view; view = view->mOuter) {
+      if (view->mOntology == this)
+         return view->mEpoch;
+   }
+   return mWriting;
+}
+
+/// Get the epoch to cache results under, on the current thread. Results      
+/// cached by the writer's thread belong to the epoch being written, which    
+/// is then left by the next mutation, so that they don't outlive it          
+///   @return the epoch of the thread's view of this ontology, or the epoch   
+///           being written, if the thread isn't viewing it                   
+auto Ontology::GetCacheEpoch() const -> Epoch {
+   for (auto view = tView; view; view = view->mOuter) {
+      if (view->mOntology == this)
+         return view->mEpoch;
+   }
+
+   mWritingCached = true;
+   return mWriting;
+}
+
+/// Get the epoch to learn in, beginning a new one if results were cached     
+/// under the current one - those results don't include what's learned next   
+///   @return the epoch being written                                         
+auto Ontology::Writing() -> Epoch {
+   if (mWritingCached.exchange(false))
+      ++mWriting;
+   return mWriting;
+}
+
+/// Get the oldest epoch any reader might still be viewing                    
+///   @return the epoch                                                       
+auto Ontology::OldestView() const -> Epoch {
+   const ::std::lock_guard lock {mReadersGuard};
+   return mReaders.empty() ? mPublished.load() : mReaders.begin()->first;
+}
+
+/// Link an idea in the epoch being written                                   
+///   @param links - the links to append to                                   
+///   @param idea - the idea to link                                          
+///   @return true if the idea wasn't linked already                          
+bool Ontology::AddLink(Links& links, Idea* idea) {
+   if (not links.Append(idea, Writing(), OldestView()))
+      return false;
+
+   mDirty = true;
+   Metrics::Add(Metrics::LinksAdded);
+   return true;
+}
+
+/// Unlink an idea in the epoch being written                                 
+///   @param links - the links to remove from                                 
+///   @param idea - the idea to unlink                                        
+///   @return true if the idea was linked                                     
+bool Ontology::RemoveLink(Links& links, const Idea* idea) {
+   if (not links.Remove(idea, Writing(), OldestView()))
+      return false;
+
+   mDirty = true;
+   return true;
+}
+
+/// Transfer a connected subgraph of ideas from another ontology, in a single 
+/// batch. The subgraph is gathered breadth-first from the roots, until the   
+/// budget is exhausted, and only links between transferred ideas are kept.   
+/// Ideas that are already known are reused, and descriptors are referenced   
+/// instead of copied - only descriptors made of other ideas are remapped     
+///   @param from - the ontology to transfer from, can be read concurrently   
+///   @param roots - the ideas to start from, must be produced by 'from'      
+///   @param budget - maximum number of ideas to gather, roots are always     
+///      transferred, regardless of it                                        
+///   @return the transferred roots, in the same order                        
+auto Ontology::Transfer(const Ontology& from, const Ideas& roots, Count budget) -> Ideas {
+   if (&from == this)
+      return roots;
+
+   const auto view = from.Read();
+
+   // Gather the subgraph                                               
+   TUnorderedMap<const Idea*, Idea*> mapped;
+   ::std::vector<const Idea*> gathered;
+   const auto gather = [&](const Idea* idea) {
+      if (mapped.ContainsKey(idea))
+         return;
+      mapped.Insert(idea, nullptr);
+      gathered.push_back(idea);
+   };
+
+   for (auto root : roots)
+      gather(root);
+   for (Offset i = 0; i < gathered.size() and gathered.size() < budget; ++i) {
+      for (auto idea : gathered[i]->GetAssociations()) {
+         if (gathered.size() < budget)
+            gather(idea);
+      }
+      for (auto idea : gathered[i]->GetDisassociations()) {
+         if (gathered.size() < budget)
+            gather(idea);
+      }
+   }
+
+   // Find or produce the local counterpart of each idea. Composite     
+   // descriptors refer to ideas of the other ontology, so their parts  
+   // are resolved first. Parts are always local, even if they're known 
+   // by a shared layer, so that they can be referred to by index       
+   const auto resolve = [&](auto& self, const Idea* idea) -> Idea* {
+      const auto found = mapped.FindIt(idea);
+      if (found and found.GetValue())
+         return found.GetValue();
+
+      Many descriptor;
+      if (idea->mDescriptor.Is<Idea>()) {
+         if (idea->mDescriptor.IsOr())
+            descriptor.MakeOr();
+         idea->mDescriptor.ForEach([&](const Idea& part) {
+            auto counterpart = self(self, &part);
+            if (counterpart->GetOntology() != this)
+               mapped[&part] = counterpart = Shadow(counterpart);
+            descriptor << counterpart;
+         });
+      }
+      else descriptor = idea->mDescriptor;
+
+      auto local = Find(descriptor);
+      if (not local)
+         local = Produce(descriptor);
+      mapped[idea] = local;
+      return local;
+   };
+
+   for (auto idea : gathered)
+      resolve(resolve, idea);
+
+   // Restore links between the transferred ideas. Shared ideas are     
+   // shadowed only if something new is linked to them                  
+   const auto local = [&](const Idea* idea) {
+      auto& counterpart = mapped[idea];
+      if (counterpart->GetOntology() != this)
+         counterpart = Shadow(counterpart);
+      return counterpart;
+   };
+
+   const auto link = [&](const Idea* idea, const Links::View& links, bool associate) {
+      for (auto other : links) {
+         const auto found = mapped.FindIt(other);
+         if (not found)
+            continue;
+
+         const auto known = associate
+            ? mapped[idea]->HasAssociation(found.GetValue())
+            : mapped[idea]->HasDisassociation(found.GetValue());
+         if (known)
+            continue;
+
+         auto a = local(idea);
+         auto b = local(other);
+         if (AddLink(associate ? a->mAssociations : a->mDisassociations, b))
+            Linked(*a, *b, associate);
+      }
+   };
+
+   for (auto idea : gathered) {
+      link(idea, idea->GetAssociations(), true);
+      link(idea, idea->GetDisassociations(), false);
+   }
+
+   mCache.Clear();
+   VERBOSE_AI("Transferred ", gathered.size(), " ideas from ", from.Self());
+
+   Ideas result;
+   result.Reserve(roots.GetCount());
+   for (auto root : roots)
+      result << mapped[root];
+   return result;
+}
+
 /// Interpret some text                                                       
 ///   @param text - text to interpret                                         
 ///   @return the hierarchy of ideas in the text                              
@@ -202,89 +953,193 @@ auto Ontology::Interpret(const Text& text) const -> Many {
       return {};
 
    // Is the text available in the cache? Directly return it if so      
-   VERBOSE_AI_INTERPRET_TAB("Interpreting: ", text);
-   const auto cached = mCache.FindIt(text);
-   if (cached) {
-      VERBOSE_AI_INTERPRET("Cached: ", cached.GetValue());
-      return cached.GetValue();
+   Metrics::Add(Metrics::Interpretations);
+   Many cached;
+   const auto epoch = GetCacheEpoch();
+   if (mCache.Find(text, epoch, cached)) {
+      Metrics::Add(Metrics::InterpretCacheHits);
+      VERBOSE_AI_INTERPRET("Cached: ", text, " -> ", cached);
+      return cached;
    }
 
+   // Lowercase the text only once - the lowercase variants of all      
+   // tokens of all suffixes are selected from it, without allocating   
+   return Interpret(text, text.Lowercase(), epoch);
+}
+
+/// Interpret some text that isn't cached yet                                 
+///   @param text - text to interpret                                         
+///   @param lowercase - the same text, but lowercase                         
+///   @param epoch - the epoch the text is interpreted in                     
+///   @return the hierarchy of ideas in the text                              
+auto Ontology::Interpret(const Text& text, const Text& lowercase, Epoch epoch) const -> Many {
+   AI_TRACE("Ontology::Interpret");
+   VERBOSE_AI_INTERPRET_TAB("Interpreting: ", text);
+
+   Many result;
+   for (Offset i = 1; i <= text.GetCount(); ++i)
+      InterpretPrefix(text, lowercase, i, epoch, result);
+   Interpreted(text, result, epoch);
+   return result;
+}
+
+/// Interpret a single prefix of some text, nesting the interpretation of the 
+/// rest of the text, and merge it with the interpretations of the other      
+/// prefixes                                                                  
+///   @param text - text to interpret                                         
+///   @param lowercase - the same text, but lowercase                         
+///   @param length - length of the prefix                                    
+///   @param epoch - the epoch the text is interpreted in                     
+///   @param result - [in/out] interpretations of the shorter prefixes        
+void Ontology::InterpretPrefix(
+   const Text& text, const Text& lowercase, Offset length, Epoch epoch, Many& result
+) const {
    // Since this is a natural language module, plausible interpret-     
    // ations may overlap, and are later weighted and filtered by        
    // context.                                                          
-   Many result;
-   for (Offset i = 1; i <= text.GetCount(); ++i) {
-      Many pattern;
-      Text token = text.Select(0, i);
-      auto lower = token.Lowercase();
-      
-      // Figure out the pattern                                         
-      if (token == lower) {
-         auto idea = mIdeas.Find(token);
-         if (idea)
-            pattern = idea;
+   Many pattern;
+   const auto token = text.Select(0, length);
+   const auto lower = lowercase.Select(0, length);
+
+   // Figure out the pattern                                            
+   if (token == lower) {
+      auto idea = Find(token);
+      if (idea)
+         pattern = idea;
+   }
+   else {
+      auto idea1 = Find(token);
+      auto idea2 = Find(lower);
+      if (idea1 and idea2) {
+         pattern << idea1 << idea2;
+         pattern.MakeOr();
       }
-      else {
-         auto idea1 = mIdeas.Find(token);
-         auto idea2 = mIdeas.Find(lower);
-         if (idea1 and idea2) {
-            pattern << idea1 << idea2;
-            pattern.MakeOr();
-         }
-         else if (idea1) {
-            pattern << idea1;
-         }
-         else if (idea2) {
-            pattern << token << idea2;
-            pattern.MakeOr();
-         }
+      else if (idea1) {
+         pattern << idea1;
       }
+      else if (idea2) {
+         pattern << token << idea2;
+         pattern.MakeOr();
+      }
+   }
 
-      if (not pattern and i != 1)
-         continue;
+   if (not pattern and length != 1)
+      return;
 
-      if (not pattern)
-         pattern << token;
+   if (not pattern)
+      pattern << token;
 
-      // If an idea was found, than this is a worthy pattern            
-      // Otherwise we push it ONLY if token is the smallest             
-      // Nest for the tail - optimize whenever possible by grouping     
-      // similar data                                                   
-      if (i < text.GetCount()) {
-         auto tail = Interpret(text.Select(i));
-         pattern << Abandon(tail);
+   // If an idea was found, than this is a worthy pattern               
+   // Otherwise we push it ONLY if token is the smallest                
+   // Nest for the tail - optimize whenever possible by grouping        
+   // similar data                                                      
+   if (length < text.GetCount()) {
+      const auto suffix = text.Select(length);
+      Many tail;
+      if (not mCache.Find(suffix, epoch, tail))
+         tail = Interpret(suffix, lowercase.Select(length), epoch);
+      pattern << Abandon(tail);
 
-         OptimizeFor<Text>(pattern);
-         OptimizeFor<Idea*>(pattern);
-         pattern.Optimize(); //TODO remove this when auto-optimization starts to happen properly on Loop::Discard
-      }
+      OptimizeFor<Text>(pattern);
+      OptimizeFor<Idea*>(pattern);
+      pattern.Optimize(); //TODO remove this when auto-optimization starts to happen properly on Loop::Discard
+   }
 
-      // Cache and merge the interpretation                             
-      VERBOSE_AI_INTERPRET("Final (previous): ", text, " -> ", result);
-      VERBOSE_AI_INTERPRET("Final (optimized): ", text, " -> ", pattern);
-      mCache.Insert(text, pattern);
-      
-      // Avoid duplication                                              
-      bool found = false;
-      result.ForEachDeep<false, false>([&](const Many& group) {
-         if (group == pattern) {
-            found = true;
-            return Loop::Break;
-         }
-         return Loop::Continue;
-      });
+   VERBOSE_AI_INTERPRET("Final (previous): ", text, " -> ", result);
+   VERBOSE_AI_INTERPRET("Final (optimized): ", text, " -> ", pattern);
 
-      if (not found) {
-         // Push to front, because each new subtoken is longer          
-         // and thus more likely to be the best one                     
-         result >> Abandon(pattern);
+   // Avoid duplication                                                 
+   bool found = false;
+   result.ForEachDeep<false, false>([&](const Many& group) {
+      if (group == pattern) {
+         found = true;
+         return Loop::Break;
       }
-      else VERBOSE_AI_INTERPRET(Logger::Red, "Discarded: ", pattern);
+      return Loop::Continue;
+   });
+
+   if (not found) {
+      // Push to front, because each new subtoken is longer             
+      // and thus more likely to be the best one                        
+      result >> Abandon(pattern);
    }
+   else VERBOSE_AI_INTERPRET(Logger::Red, "Discarded: ", pattern);
+}
 
+/// Complete the interpretation of some text, once all of its prefixes were   
+/// interpreted, and cache all of it                                          
+///   @param text - the interpreted text                                      
+///   @param result - [in/out] interpretations of all prefixes                
+///   @param epoch - the epoch the text was interpreted in                    
+void Ontology::Interpreted(const Text& text, Many& result, Epoch epoch) const {
    if (result.GetCount() > 1)
       result.MakeOr();
-   return result;
+   mCache.Insert(text, result, epoch);
+}
+
+/// Advance an interpretation by a single step - interpreting one prefix of   
+/// the current suffix, or skipping the suffix if it is already cached        
+///   @param work - the interpretation to advance                             
+///   @return true if the interpretation has completed                        
+bool Ontology::Advance(Interpretation& work) const {
+   if (not work.mNext)
+      return true;
+
+   // Learning begins new epochs - a suffix that was begun in an older  
+   // one is started over, so that it never mixes versions              
+   const auto epoch = GetCacheEpoch();
+   if (epoch != work.mEpoch) {
+      work.mPrefix = 0;
+      work.mPartial.Reset();
+      work.mEpoch = epoch;
+   }
+
+   const auto start = work.mNext - 1;
+   const auto suffix = work.mText.Select(start);
+   if (not work.mPrefix) {
+      Many cached;
+      if (mCache.Find(suffix, epoch, cached)) {
+         work.mPartial = cached;
+         work.mPrefix = suffix.GetCount();
+      }
+   }
+
+   if (work.mPrefix < suffix.GetCount()) {
+      ++work.mPrefix;
+      InterpretPrefix(suffix, work.mLowercase.Select(start), work.mPrefix, epoch, work.mPartial);
+      if (work.mPrefix < suffix.GetCount())
+         return false;
+      Interpreted(suffix, work.mPartial, epoch);
+   }
+
+   // The suffix is complete, continue with a longer one next time      
+   --work.mNext;
+   work.mPrefix = 0;
+   if (work.mNext)
+      work.mPartial.Reset();
+   else
+      work.mResult = Abandon(work.mPartial);
+   return not work.mNext;
+}
+
+/// Begin interpreting some text                                              
+///   @param text - the text to interpret                                     
+Ontology::Interpretation::Interpretation(const Text& text)
+   : mText {text}
+   , mLowercase {text.Lowercase()}
+   , mNext {text.GetCount()} {}
+
+/// Check if the whole text was interpreted                                   
+///   @return true if the result is available                                 
+bool Ontology::Interpretation::IsDone() const noexcept {
+   return not mNext;
+}
+
+/// Get the interpretation of the whole text                                  
+///   @attention only valid after IsDone() returns true                       
+///   @return the hierarchy of ideas in the text                              
+auto Ontology::Interpretation::GetResult() noexcept -> Many& {
+   return mResult;
 }
 
 
@@ -305,7 +1160,7 @@ auto Ontology::Interpret(const Text& text) const -> Many {
          auto idea = mIdeas.Find(pattern);
          if (not idea)
             continue;
-         
+
          // Metapattern found                                           
          atLeastOneMetapatternFound = true;
          auto substitution = Many::FromState(pattern);
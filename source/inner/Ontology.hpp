@@ -1,9 +1,15 @@
 #pragma once
 #include "Idea.hpp"
+#include "Cache.hpp"
+#include "Journal.hpp"
+#include "Paging.hpp"
+#include "Workers.hpp"
 #include <Langulus/Verbs/Associate.hpp>
 #include <Langulus/Verbs/Create.hpp>
 #include <Langulus/Verbs/Select.hpp>
 #include <Langulus/Flow/Factory.hpp>
+#include <map>
+#include <mutex>
 
 
 ///                                                                           
@@ -13,24 +19,139 @@ struct Ontology {
    LANGULUS_VERBS(Verbs::Create, Verbs::Select);
 
 private:
-   // The owning component                                              
-   const A::AIUnit& mOwner;
+   friend struct Idea;
+
+   // The owning component, if any - standalone ontologies are used by  
+   // tools, tests and benchmarks                                       
+   const A::AIUnit* mOwner = nullptr;
+
+   // Unique for each ontology ever produced, so that an ontology can be
+   // told apart from a destroyed one at the same address               
+   const ::std::uint64_t mSerial = NextSerial();
 
    // The ideas                                                         
    TFactoryUnique<Idea> mIdeas;
 
    // Quick text indexer and auto-completer - iterating all text        
    // combinations in a prompt is costly - use that as an optimization  
-   mutable TUnorderedMap<Text, Many> mCache;
+   // The cache is sharded, so that concurrent readers can share it     
+   Cache mCache;
+
+   // Ideas and links are multiversioned, so that a single writer can   
+   // keep learning, while any number of readers interpret a consistent 
+   // version of the ontology. Everything learned belongs to the epoch  
+   // being written, which becomes visible once published               
+   // Publishing only begins a new epoch if something was learned since 
+   // the last one, so that caches survive writers that changed nothing 
+   Epoch mWriting = 1;
+   ::std::atomic<Epoch> mPublished = 0;
+   ::std::mutex mWriter;
+   bool mDirty = false;
+
+   // The writer's thread reads the epoch being written, and caches its 
+   // results under it - the next mutation begins a new epoch, so that  
+   // those results go stale, instead of missing what was learned       
+   mutable ::std::atomic<bool> mWritingCached = false;
+
+   // Number of readers viewing each epoch                              
+   mutable ::std::mutex mReadersGuard;
+   mutable ::std::map<Epoch, Count> mReaders;
+
+   // The factory itself isn't versioned, only guarded                  
+   mutable ::std::mutex mFactoryGuard;
+
+   // Shared ontologies this one is layered over, searched in order for 
+   // ideas that aren't known locally. Learning never modifies them -   
+   // shared ideas are shadowed by local ones instead, that keep only   
+   // what was learned on top                                           
+   // Layers are copied on write and versioned like links, so readers   
+   // keep seeing the layers of their view, while the owner joins other 
+   // societies. The flag spares lookups from loading them, if there    
+   // are no layers in any version                                      
+   struct Layers {
+      ::std::vector<const Ontology*> mOntologies;
+      Epoch mEpoch = 0;
+      ::std::atomic<::std::shared_ptr<const Layers>> mPrevious;
+   };
+   ::std::atomic<::std::shared_ptr<Layers>> mShared {::std::make_shared<Layers>()};
+   ::std::atomic<bool> mLayered = false;
+   TUnorderedMap<const Idea*, Idea*> mShadows;
 
    Count mLongestKnownText = 0;
 
+   // All ideas in order of creation - snapshots and journals refer to  
+   // ideas by their index in this sequence. Forgetting an idea moves   
+   // the last one in its place, so that no other index changes         
+   Ideas mOrder;
+
+   // Number of ideas ever removed from the sequence - a change tells   
+   // that an index might now refer to a different idea                 
+   ::std::uint64_t mForgets = 0;
+
+   // Persistent base image, and a journal of all mutations since it    
+   // was last compacted. When the journal grows too big, a new one is  
+   // started, and the old one is folded into the base image on a       
+   // background thread                                                 
+   Text mBasePath;
+   Journal mJournal;
+   Size mCompactThreshold = 64 * 1024 * 1024;
+   ::std::uint64_t mGeneration = 0;
+   ::std::atomic<bool> mCompacting = false;
+   Background mCompactor;
+
+   // On-disk partitions, loaded on demand when the ontology is paged   
+   mutable Pager mPager;
+
+   // Forgotten and paged out ideas, with the epoch they were retired in.
+   // Readers with older views might still be walking them, so they are 
+   // destroyed only once all such views have ended                     
+   ::std::vector<::std::pair<Epoch, Idea*>> mRetired;
+
+   static auto NextSerial() noexcept -> ::std::uint64_t;
    Text Self() const;
+   void Register(Idea&);
+   void Unregister(Idea&);
+   void Forget(Idea*);
+   void Linked(const Idea&, const Idea&, bool associate);
+
+   auto Find(const Many&) const -> Idea*;
+   auto Lookup(const Many&) const -> Idea*;
+   auto FindShared(const Many&) const -> const Idea*;
+   static auto HashDescriptor(const Many&) -> ::std::uint64_t;
+   auto GetLayers() const -> ::std::shared_ptr<const Layers>;
+   void SetLayers(::std::vector<const Ontology*>&&);
+   auto Spawn(const Many&) -> Idea*;
+   bool AddLink(Links&, Idea*);
+   bool RemoveLink(Links&, const Idea*);
+   auto Writing() -> Epoch;
+   auto OldestView() const -> Epoch;
+   auto Produce(const Many&) -> Idea*;
+   void Fault(const Many&) const;
+   void PageIn(Offset) const;
+   void PageOut(Offset);
+   void Evict();
+   void Retire(Idea*);
+   void Revive(Idea*);
+   void Reclaim();
+   void Destroy(Idea*);
+
+   bool Encode(const Idea&, const TUnorderedMap<const Idea*, ::std::uint32_t>*, Bytes&) const;
+   template<class WRITER>
+   bool WriteImage(WRITER&, const Ideas&) const;
+   bool LoadImage(const Byte*, Size, Ideas&);
+   bool LoadBase(const Text&);
+   bool SaveAtomically(const Text&) const;
+   void CompactLater();
+   static bool Fold(const Text& base, const Text& journal);
 
    template<class FOR>
    void OptimizeFor(Many&) const;
+   auto Interpret(const Text&, const Text& lower, Epoch) const -> Many;
+   void InterpretPrefix(const Text&, const Text& lower, Offset, Epoch, Many&) const;
+   void Interpreted(const Text&, Many&, Epoch) const;
 
 public:
+   Ontology() = default;
    Ontology(const A::AIUnit&);
    Ontology(const A::AIUnit&, const Many&);
 
@@ -38,8 +159,98 @@ public:
    void Select(Verb&);
 
    auto Build(const Many&, bool findMetapatterns = true) -> Idea*;
+   auto Transfer(const Ontology&, const Ideas&, Count budget) -> Ideas;
    auto BuildText(const Text&) -> Idea*;
    auto Interpret(const Text&) const -> Many;
    //bool FindMetapatterns(Many&) const;
    void Teardown();
+
+   /// An interpretation that can be interrupted and resumed. Suffixes of     
+   /// the text are interpreted from the shortest to the longest, and each    
+   /// suffix one prefix at a time, reusing the cached interpretations of     
+   /// all shorter suffixes - so every step is short                          
+   struct Interpretation {
+   private:
+      friend struct Ontology;
+      Text mText;
+      Text mLowercase;
+      // Number of suffixes left to interpret, counting down to zero    
+      Offset mNext = 0;
+      // Number of prefixes of the current suffix interpreted so far    
+      Offset mPrefix = 0;
+      // The epoch the current suffix is interpreted in - if it changes 
+      // midway, the suffix is started over                             
+      Epoch mEpoch = 0;
+      Many mPartial;
+      Many mResult;
+
+   public:
+      Interpretation(const Text&);
+
+      bool IsDone() const noexcept;
+      auto GetResult() noexcept -> Many&;
+   };
+
+   bool Advance(Interpretation&) const;
+
+   /// A consistent version of the ontology, seen by a reader thread          
+   struct View {
+   private:
+      friend struct Ontology;
+      const Ontology* mOntology;
+      Epoch mEpoch;
+      const View* mOuter;
+
+      View(const Ontology*);
+
+   public:
+      View(const View&) = delete;
+      ~View();
+   };
+
+   /// Exclusive right to learn, publishing everything learned when done      
+   struct Writer {
+   private:
+      friend struct Ontology;
+      Ontology* mOntology;
+      ::std::unique_lock<::std::mutex> mLock;
+
+      Writer(Ontology*);
+
+   public:
+      Writer(const Writer&) = delete;
+      ~Writer();
+   };
+
+   auto Read() const -> View;
+   auto Write() -> Writer;
+   void Publish();
+
+   void Share(const Ontology&);
+   void Unshare(const Ontology&);
+   auto Adopt(const ::std::vector<const Ontology*>&, Count quorum) -> Count;
+   auto Prune() -> Count;
+   bool IsSharing(const Ontology*) const;
+   auto Overlay(const Idea*) const -> const Idea*;
+   auto Shadow(const Idea*) -> Idea*;
+   auto GetEpoch() const -> Epoch;
+   auto GetCacheEpoch() const -> Epoch;
+   auto GetSerial() const noexcept -> ::std::uint64_t;
+   auto GetIdeaCount() const noexcept -> Count;
+   auto GetForgetCount() const noexcept -> ::std::uint64_t;
+   auto GetIdeaHash(Offset) const -> ::std::uint64_t;
+
+   bool Save(const Text&) const;
+   auto Save() const -> Bytes;
+   bool Load(const Text&);
+   bool Load(const Byte*, Size);
+
+   bool Persist(const Text& base, const Text& journal);
+   bool Replay(const Text&);
+   bool Compact(const Text& journal);
+   void Update();
+
+   bool SavePaged(const Text&, Count partitionSize) const;
+   bool Page(const Text&, Count budget);
+   bool IsPaged() const noexcept;
 };
@@ -0,0 +1,439 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Paging.hpp"
+#include "Snapshot.hpp"
+#include "Ontology.hpp"
+#include <algorithm>
+#include <cstring>
+
+
+/// Check if an ontology is paged                                             
+///   @return true if a paged file is mapped                                  
+bool Pager::IsActive() const noexcept {
+   return static_cast<bool>(mFile);
+}
+
+/// Find the keys of all ideas with the given descriptor hash - different     
+/// descriptors might have the same hash, and be in different partitions      
+///   @param hash - the hash of the idea's descriptor                         
+///   @return the range of keys with that hash, empty if none                 
+auto Pager::FindKeys(::std::uint64_t hash) const noexcept
+-> ::std::pair<const PagedKey*, const PagedKey*> {
+   struct Less {
+      bool operator () (const PagedKey& key, ::std::uint64_t h) const noexcept {
+         return key.mHash < h;
+      }
+      bool operator () (::std::uint64_t h, const PagedKey& key) const noexcept {
+         return h < key.mHash;
+      }
+   };
+
+   return ::std::equal_range(mKeys, mKeys + mKeyCount, hash, Less {});
+}
+
+/// Mark the partition of an idea as used in the current update cycle         
+///   @param idea - the idea that was used                                    
+void Pager::Touch(const Idea* idea) {
+   const auto found = mPartitionOf.FindIt(idea);
+   if (found)
+      mState[found.GetValue()].mLastUsed = mClock;
+}
+
+/// Pin the partition of an idea, so that it is never evicted                 
+///   @param idea - the idea that was modified                                
+void Pager::Pin(const Idea* idea) {
+   const auto found = mPartitionOf.FindIt(idea);
+   if (found)
+      mState[found.GetValue()].mPinned = true;
+}
+
+/// Forget about all partitions and unmap the file                            
+void Pager::Reset() {
+   mState.clear();
+   mPartitionOf.Reset();
+   mFile.Close();
+   mPartitions = nullptr;
+   mKeys = nullptr;
+   mKeyCount = 0;
+   mResidentIdeas = 0;
+}
+
+
+/// Find an idea by its descriptor, paging in its partition if needed         
+///   @param key - the descriptor of the idea                                 
+///   @return the idea if found, or nullptr                                   
+auto Ontology::Find(const Many& key) const -> Idea* {
+   auto idea = Lookup(key);
+   if (mPager.IsActive()) {
+      if (idea)
+         mPager.Touch(idea);
+      else {
+         Fault(key);
+         idea = Lookup(key);
+      }
+   }
+
+   // Fall through to the shared layers                                 
+   if (not idea)
+      idea = const_cast<Idea*>(FindShared(key));
+   return idea;
+}
+
+/// Find an idea by its descriptor in the factory, if visible to the current  
+/// thread - ideas learned after the thread's view are not                    
+///   @param key - the descriptor of the idea                                 
+///   @return the idea if found, or nullptr                                   
+auto Ontology::Lookup(const Many& key) const -> Idea* {
+   Idea* idea;
+   {
+      const ::std::lock_guard lock {mFactoryGuard};
+      idea = mIdeas.Find(key);
+   }
+   if (not idea)
+      return nullptr;
+
+   const auto epoch = GetEpoch();
+   return idea->mEpoch <= epoch and epoch < idea->mForgotten ? idea : nullptr;
+}
+
+/// Produce an idea in the factory, guarding it against concurrent readers    
+///   @param descriptor - the descriptor of the idea                          
+///   @return the new or existing idea                                        
+auto Ontology::Spawn(const Many& descriptor) -> Idea* {
+   Idea* idea;
+   {
+      const ::std::lock_guard lock {mFactoryGuard};
+      idea = mIdeas.CreateOne(this, descriptor);
+   }
+
+   // Retired ideas stay in the factory until they are reclaimed        
+   if (idea and idea->mForgotten != Idea::Remembered)
+      Revive(idea);
+   return idea;
+}
+
+/// Produce an idea, making sure that an idea with the same descriptor isn't  
+/// waiting in a partition that wasn't paged in yet                           
+///   @param descriptor - the descriptor of the idea                          
+///   @return the new or existing idea                                        
+auto Ontology::Produce(const Many& descriptor) -> Idea* {
+   if (mPager.IsActive())
+      Fault(descriptor);
+   return Spawn(descriptor);
+}
+
+/// Page in the partition that contains an idea with the given key, if any    
+///   @param key - the descriptor of the idea                                 
+void Ontology::Fault(const Many& key) const {
+   // Partitions of all ideas with the same hash are tried in turn,     
+   // until the idea shows up                                           
+   const auto [first, last] = mPager.FindKeys(HashDescriptor(key));
+   for (auto candidate = first; candidate != last; ++candidate) {
+      auto& state = mPager.mState[candidate->mPartition];
+      if (not state.mResident)
+         PageIn(candidate->mPartition);
+      state.mLastUsed = mPager.mClock;
+
+      if (Lookup(key))
+         return;
+   }
+}
+
+/// Load a partition from the mapped file                                     
+/// Eviction never happens here, because the caller might still be holding    
+/// ideas from other partitions - it is deferred until Ontology::Update       
+///   @param partition - the partition to load                                
+void Ontology::PageIn(Offset partition) const {
+   auto self = const_cast<Ontology*>(this);
+   auto& state = mPager.mState[partition];
+   const auto& record = mPager.mPartitions[partition];
+
+   // Ideas registered while loading are the ones that belong to the    
+   // partition - any that were already known are just reused           
+   Ideas loaded;
+   const auto before = mOrder.GetCount();
+   if (not self->LoadImage(mPager.mFile.GetRaw() + record.mOffset, record.mSize, loaded)) {
+      Logger::Error(Self(), "Failed paging in partition #", partition);
+      return;
+   }
+
+   for (Offset i = before; i < mOrder.GetCount(); ++i) {
+      state.mIdeas.push_back(mOrder[i]);
+      mPager.mPartitionOf.Insert(mOrder[i], partition);
+   }
+
+   state.mResident = true;
+   mPager.mResidentIdeas += state.mIdeas.size();
+   VERBOSE_AI("Paged in partition #", partition, " with ",
+      state.mIdeas.size(), " ideas");
+}
+
+/// Unload a partition, retiring all of its ideas                             
+///   @param partition - the partition to unload                              
+void Ontology::PageOut(Offset partition) {
+   // Each evicted idea's index is taken by the last idea, so eviction  
+   // costs only as much as the partition is big. That changes indices, 
+   // which is why paged ontologies can't be journaled                  
+   auto& state = mPager.mState[partition];
+   for (auto idea : state.mIdeas) {
+      mPager.mPartitionOf.RemoveKey(idea);
+      Unregister(*idea);
+   }
+
+   // Partitions are closed, so links only go between evicted ideas.    
+   // They are kept intact for readers that might still walk them, and  
+   // torn down when the ideas are reclaimed                            
+   for (auto idea : state.mIdeas)
+      Retire(idea);
+
+   mPager.mResidentIdeas -= state.mIdeas.size();
+   state.mIdeas.clear();
+   state.mResident = false;
+   mCache.Clear();
+   VERBOSE_AI("Paged out partition #", partition);
+}
+
+/// Destroy an idea, removing it from the factory                             
+///   @param idea - the idea to destroy                                       
+void Ontology::Destroy(Idea* idea) {
+   Verbs::Create destruction {Construct::From<Idea>(Many {idea->mDescriptor})};
+   destruction.SetMass(-1);
+   const ::std::lock_guard lock {mFactoryGuard};
+   mIdeas.Create(this, destruction);
+}
+
+/// Save the ontology as a paged file. Connected groups of ideas are packed   
+/// together into partitions, so that they can later be loaded on demand      
+///   @param path - the file to write                                         
+///   @param partitionSize - the preferred number of ideas per partition,     
+///      connected groups larger than that are never split                    
+///   @return true if the file was written successfully                       
+bool Ontology::SavePaged(const Text& path, Count partitionSize) const {
+   // Find connected groups of ideas via union-find over all links      
+   TUnorderedMap<const Idea*, Offset> indices;
+   for (auto idea : mOrder)
+      indices.Insert(idea, indices.GetCount());
+
+   ::std::vector<Offset> parent(mOrder.GetCount());
+   for (Offset i = 0; i < parent.size(); ++i)
+      parent[i] = i;
+
+   const auto root = [&parent](Offset i) {
+      while (parent[i] != i)
+         i = parent[i] = parent[parent[i]];
+      return i;
+   };
+
+   const auto join = [&](Offset from, const Idea* other) {
+      const auto to = root(indices[other]);
+      if (from != to)
+         parent[to] = from;
+   };
+
+   // Ideas are kept together with the ideas they are made of too, so   
+   // that partitions can refer to them by index                        
+   for (auto idea : mOrder) {
+      const auto from = root(indices[idea]);
+      for (const auto& links : {idea->mAssociations.Latest(), idea->mDisassociations.Latest()}) {
+         for (auto other : links)
+            join(from, other);
+      }
+
+      if (idea->mDescriptor.Is<Idea>()) {
+         idea->mDescriptor.ForEach([&](const Idea& part) {
+            join(from, &part);
+         });
+      }
+   }
+
+   // Gather groups in order of first appearance, and pack them         
+   ::std::vector<::std::vector<Offset>> groups;
+   ::std::vector<Offset> groupOf(mOrder.GetCount(), Pager::NoPartition);
+   for (Offset i = 0; i < mOrder.GetCount(); ++i) {
+      auto& group = groupOf[root(i)];
+      if (group == Pager::NoPartition) {
+         group = groups.size();
+         groups.emplace_back();
+      }
+      groups[group].push_back(i);
+   }
+
+   ::std::vector<Ideas> partitions;
+   for (auto& group : groups) {
+      if (partitions.empty()
+      or (partitions.back().GetCount()
+         and partitions.back().GetCount() + group.size() > partitionSize))
+         partitions.emplace_back();
+      for (auto i : group)
+         partitions.back() << mOrder[i];
+   }
+
+   // Write partitions, each being a complete snapshot image            
+   FileWriter file;
+   if (not file.Open(path)) {
+      Logger::Error(Self(), "Can't open `", path, "` for writing");
+      return false;
+   }
+
+   bool ok = true;
+   ::std::vector<PagedPartition> table;
+   ::std::vector<PagedKey> keys;
+   for (auto& ideas : partitions) {
+      PagedPartition record {};
+      record.mOffset = file.GetWritten();
+      record.mIdeaCount = ideas.GetCount();
+      ok &= WriteImage(file, ideas);
+      record.mSize = file.GetWritten() - record.mOffset;
+
+      for (auto idea : ideas) {
+         PagedKey key {};
+         key.mHash = HashDescriptor(idea->mDescriptor);
+         key.mPartition = static_cast<::std::uint32_t>(table.size());
+         keys.push_back(key);
+      }
+
+      table.push_back(record);
+   }
+
+   ::std::sort(keys.begin(), keys.end(),
+      [](const PagedKey& a, const PagedKey& b) { return a.mHash < b.mHash; });
+
+   PagedTrailer trailer {};
+   ::std::memcpy(trailer.mMagic, PagedTrailer::Magic, sizeof(trailer.mMagic));
+   trailer.mVersion = PagedTrailer::CurrentVersion;
+   trailer.mEndianness = PagedTrailer::NativeEndianness;
+   trailer.mPartitionCount = table.size();
+   trailer.mKeyCount = keys.size();
+   trailer.mPartitionsOffset = file.GetWritten();
+   trailer.mKeysOffset = trailer.mPartitionsOffset
+                       + table.size() * sizeof(PagedPartition);
+
+   ok &= file.Write(table.data(), table.size() * sizeof(PagedPartition));
+   ok &= file.Write(keys.data(), keys.size() * sizeof(PagedKey));
+   ok &= file.WritePOD(trailer);
+
+   if (not ok) {
+      Logger::Error(Self(), "Failed writing paged ontology `", path, '`');
+      return false;
+   }
+
+   VERBOSE_AI("Saved ", mOrder.GetCount(), " ideas in ",
+      table.size(), " partitions to `", path, '`');
+   return true;
+}
+
+/// Back the ontology by a paged file. Nothing is loaded right away - each    
+/// partition is loaded the first time one of its ideas is needed, and the    
+/// least recently used partitions are evicted on Update, while more than     
+/// 'budget' paged ideas are resident.                                        
+/// Ideas from a paged ontology are only guaranteed to stay valid until the   
+/// next Update, unless they were (dis)associated, which pins them forever.   
+///   @param path - the paged file, made with SavePaged                       
+///   @param budget - the maximum number of paged ideas to keep resident      
+///   @return true if the file was mapped successfully                        
+bool Ontology::Page(const Text& path, Count budget) {
+   if (mJournal.IsOpen() or mBasePath) {
+      // Evicting ideas renumbers them, while journals refer to them by 
+      // their index                                                    
+      Logger::Error(Self(), "Can't page a persistent ontology");
+      return false;
+   }
+
+   mPager.Reset();
+   if (not mPager.mFile.Open(path)) {
+      Logger::Error(Self(), "Can't map paged ontology `", path, '`');
+      return false;
+   }
+
+   const auto raw = mPager.mFile.GetRaw();
+   const auto size = mPager.mFile.GetSize();
+   PagedTrailer trailer;
+   if (size < sizeof(trailer)) {
+      Logger::Error(Self(), "Paged ontology `", path, "` is too small");
+      mPager.Reset();
+      return false;
+   }
+
+   ::std::memcpy(&trailer, raw + size - sizeof(trailer), sizeof(trailer));
+   if (::std::memcmp(trailer.mMagic, PagedTrailer::Magic, sizeof(trailer.mMagic))
+   or  trailer.mVersion != PagedTrailer::CurrentVersion
+   or  trailer.mEndianness != PagedTrailer::NativeEndianness) {
+      Logger::Error(Self(), "`", path, "` is not a supported paged ontology");
+      mPager.Reset();
+      return false;
+   }
+
+   // The tables are used in place, so they must be aligned, and come   
+   // before the trailer. Partitions must be before the tables, and     
+   // keys must refer to partitions - nothing is read out of bounds     
+   // when faulting later                                               
+   const auto tables = size - sizeof(trailer);
+   bool valid = trailer.mPartitionsOffset % alignof(PagedPartition) == 0
+      and trailer.mKeysOffset % alignof(PagedKey) == 0
+      and Fits(trailer.mPartitionsOffset, trailer.mPartitionCount, sizeof(PagedPartition), tables)
+      and Fits(trailer.mKeysOffset, trailer.mKeyCount, sizeof(PagedKey), tables);
+
+   const PagedPartition* partitions = nullptr;
+   const PagedKey* keys = nullptr;
+   if (valid) {
+      partitions = reinterpret_cast<const PagedPartition*>(raw + trailer.mPartitionsOffset);
+      keys = reinterpret_cast<const PagedKey*>(raw + trailer.mKeysOffset);
+   }
+
+   for (::std::uint64_t i = 0; valid and i < trailer.mPartitionCount; ++i)
+      valid = Fits(partitions[i].mOffset, partitions[i].mSize, 1, trailer.mPartitionsOffset);
+   for (::std::uint64_t i = 0; valid and i < trailer.mKeyCount; ++i) {
+      valid = keys[i].mPartition < trailer.mPartitionCount
+         and (i == 0 or keys[i - 1].mHash <= keys[i].mHash);
+   }
+
+   if (not valid) {
+      Logger::Error(Self(), "Paged ontology `", path, "` is corrupt");
+      mPager.Reset();
+      return false;
+   }
+
+   mPager.mPartitions = partitions;
+   mPager.mKeys = keys;
+   mPager.mKeyCount = trailer.mKeyCount;
+   mPager.mState.resize(trailer.mPartitionCount);
+   mPager.mBudget = budget;
+   mCache.Clear();
+   return true;
+}
+
+/// Check if ideas are paged in from disk on demand                           
+/// Paging mutates the ontology even while interpreting, so a paged           
+/// ontology can only be used on a single thread                              
+///   @return true if the ontology is paged                                   
+bool Ontology::IsPaged() const noexcept {
+   return mPager.IsActive();
+}
+
+/// Evict the least recently used partitions while over budget                
+void Ontology::Evict() {
+   while (mPager.mResidentIdeas > mPager.mBudget) {
+      Offset coldest = Pager::NoPartition;
+      for (Offset i = 0; i < mPager.mState.size(); ++i) {
+         const auto& state = mPager.mState[i];
+         if (not state.mResident or state.mPinned
+         or  state.mLastUsed == mPager.mClock)
+            continue;
+
+         if (coldest == Pager::NoPartition
+         or  state.mLastUsed < mPager.mState[coldest].mLastUsed)
+            coldest = i;
+      }
+
+      if (coldest == Pager::NoPartition)
+         break;
+      PageOut(coldest);
+   }
+
+   ++mPager.mClock;
+}
@@ -0,0 +1,99 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Storage.hpp"
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+struct Idea;
+
+
+///                                                                           
+///   Paged ontology file layout                                              
+///                                                                           
+///   [snapshot image of partition 0]                                         
+///   [snapshot image of partition 1] ...                                     
+///   [PagedPartition x trailer.mPartitionCount]                              
+///   [PagedKey x trailer.mKeyCount], sorted by hash                          
+///   [PagedTrailer]                                                          
+///                                                                           
+/// Every partition is a complete snapshot image (see Snapshot.hpp), made of  
+/// whole connected components of the idea graph, so that walking the graph   
+/// never needs to leave a partition - ideas are in the same component as     
+/// the ideas they are made of. The key table maps descriptor hashes (see     
+/// Ontology::HashDescriptor) to partitions, and is searched in place,        
+/// directly in the mapped file.                                              
+///                                                                           
+struct PagedTrailer {
+   static constexpr char Magic[8] = {'L','G','L','S','P','A','G','E'};
+   static constexpr ::std::uint32_t CurrentVersion = 2;
+   static constexpr ::std::uint32_t NativeEndianness = 0x01020304;
+
+   char            mMagic[8];
+   ::std::uint32_t mVersion;
+   ::std::uint32_t mEndianness;
+   ::std::uint64_t mPartitionCount;
+   ::std::uint64_t mKeyCount;
+   ::std::uint64_t mPartitionsOffset;
+   ::std::uint64_t mKeysOffset;
+};
+
+struct PagedPartition {
+   ::std::uint64_t mOffset;
+   ::std::uint64_t mSize;
+   ::std::uint64_t mIdeaCount;
+};
+
+struct PagedKey {
+   ::std::uint64_t mHash;
+   ::std::uint32_t mPartition;
+   ::std::uint32_t mReserved;
+};
+
+static_assert(sizeof(PagedTrailer) % 8 == 0);
+static_assert(sizeof(PagedPartition) % 8 == 0);
+static_assert(sizeof(PagedKey) % 8 == 0);
+
+
+///                                                                           
+///   Residency state of a paged ontology                                     
+///                                                                           
+struct Pager {
+   static constexpr Offset NoPartition = ::std::numeric_limits<Offset>::max();
+
+   struct Partition {
+      // Ideas that were loaded from the partition, while resident      
+      ::std::vector<Idea*> mIdeas;
+      // Update cycle in which the partition was last used              
+      Count mLastUsed = 0;
+      bool mResident = false;
+      // Pinned partitions were modified, and are never evicted         
+      bool mPinned = false;
+   };
+
+   MappedFile mFile;
+   const PagedPartition* mPartitions = nullptr;
+   const PagedKey* mKeys = nullptr;
+   Count mKeyCount = 0;
+
+   ::std::vector<Partition> mState;
+   TUnorderedMap<const Idea*, Offset> mPartitionOf;
+
+   // Maximum number of paged ideas to keep resident                    
+   Count mBudget = 0;
+   Count mResidentIdeas = 0;
+   Count mClock = 0;
+
+   bool IsActive() const noexcept;
+   auto FindKeys(::std::uint64_t) const noexcept -> ::std::pair<const PagedKey*, const PagedKey*>;
+   void Touch(const Idea*);
+   void Pin(const Idea*);
+   void Reset();
+};
@@ -0,0 +1,76 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Perception.hpp"
+#include <algorithm>
+#include <cmath>
+
+
+/// Perceive only the given verbs, replacing any previous verb filter         
+///   @param verbs - the verbs to perceive                                    
+///   @return a reference to the filter for chaining                          
+auto Perception::Only(::std::initializer_list<VMeta> verbs) -> Perception& {
+   mVerbs.assign(verbs.begin(), verbs.end());
+   mExclusive = true;
+   Compile();
+   return *this;
+}
+
+/// Perceive everything except the given verbs, replacing any previous        
+/// verb filter                                                               
+///   @param verbs - the verbs to ignore                                      
+///   @return a reference to the filter for chaining                          
+auto Perception::Ignore(::std::initializer_list<VMeta> verbs) -> Perception& {
+   mVerbs.assign(verbs.begin(), verbs.end());
+   mExclusive = false;
+   Compile();
+   return *this;
+}
+
+/// Don't perceive events with smaller magnitude of mass                      
+///   @param mass - the threshold                                             
+///   @return a reference to the filter for chaining                          
+auto Perception::MinMass(Real mass) noexcept -> Perception& {
+   mMinMass = mass;
+   return *this;
+}
+
+/// Don't perceive events with smaller priority                               
+///   @param priority - the threshold                                         
+///   @return a reference to the filter for chaining                          
+auto Perception::MinPriority(Real priority) noexcept -> Perception& {
+   mMinPriority = priority;
+   return *this;
+}
+
+/// Sort and deduplicate the verb table, so it can be binary searched         
+void Perception::Compile() {
+   ::std::sort(mVerbs.begin(), mVerbs.end());
+   mVerbs.erase(::std::unique(mVerbs.begin(), mVerbs.end()), mVerbs.end());
+   mLastType = {};
+   mLastVerdict = true;
+}
+
+/// Check if an event is perceived                                            
+///   @param verb - the event                                                 
+///   @return true if the event passes the filter                             
+bool Perception::Perceives(const Verb& verb) const noexcept {
+   if (::std::abs(verb.GetMass()) < mMinMass
+   or  verb.GetPriority() < mMinPriority)
+      return false;
+
+   if (mVerbs.empty())
+      return not mExclusive;
+
+   const auto type = verb.GetVerb();
+   if (type != mLastType) {
+      const bool listed = ::std::binary_search(mVerbs.begin(), mVerbs.end(), type);
+      mLastType = type;
+      mLastVerdict = listed == mExclusive;
+   }
+   return mLastVerdict;
+}
@@ -0,0 +1,63 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <limits>
+#include <vector>
+
+
+///                                                                           
+///   Perception filter                                                       
+///                                                                           
+/// Declares which events a mind is able to sense. Everything is perceived    
+/// by default. The declaration is compiled into a sorted table of verb       
+/// types and a couple of thresholds, so that filtering an event costs a      
+/// binary search at most, and usually just a comparison against the last     
+/// verb type that was filtered.                                              
+///                                                                           
+struct Perception {
+private:
+   // Declared verb types, that are the only ones perceived, or ignored 
+   ::std::vector<VMeta> mVerbs;
+   bool mExclusive = false;
+
+   // Events with smaller magnitude of mass, or with smaller priority   
+   // are not perceived                                                 
+   Real mMinMass = 0;
+   Real mMinPriority = ::std::numeric_limits<Real>::lowest();
+
+   // Cached verdict for the last filtered verb type                    
+   mutable VMeta mLastType {};
+   mutable bool mLastVerdict = true;
+
+   void Compile();
+
+public:
+   auto Only(::std::initializer_list<VMeta>) -> Perception&;
+   auto Ignore(::std::initializer_list<VMeta>) -> Perception&;
+   auto MinMass(Real) noexcept -> Perception&;
+   auto MinPriority(Real) noexcept -> Perception&;
+
+   /// Perceive only the given verbs                                          
+   ///   @tparam V... - the verbs to perceive                                 
+   ///   @return a reference to the filter for chaining                       
+   template<CT::Verb...V>
+   auto Only() -> Perception& {
+      return Only({MetaVerbOf<V>()...});
+   }
+
+   /// Perceive everything except the given verbs                             
+   ///   @tparam V... - the verbs to ignore                                   
+   ///   @return a reference to the filter for chaining                       
+   template<CT::Verb...V>
+   auto Ignore() -> Perception& {
+      return Ignore({MetaVerbOf<V>()...});
+   }
+
+   bool Perceives(const Verb&) const noexcept;
+};
@@ -0,0 +1,151 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Program.hpp"
+#include <algorithm>
+
+
+/// Forget all instructions, but keep the memory for reuse                    
+void Program::Clear() noexcept {
+   mCode.clear();
+   mData.clear();
+   mOpen.clear();
+   mDepth = 0;
+}
+
+/// Reserve memory for a number of instructions                               
+///   @param count - number of instructions                                   
+void Program::Reserve(Count count) {
+   mCode.reserve(count);
+}
+
+/// Append an instruction                                                     
+///   @param kind - the kind of instruction                                   
+///   @return the instruction                                                 
+auto Program::Add(Instruction::Kind kind) -> Instruction& {
+   auto& op = mCode.emplace_back();
+   op.mKind = kind;
+   op.mData = 0;
+   return op;
+}
+
+/// Emit instructions for a flow, as Mind::Compile would nest it              
+/// Verbs are acted upon, alternatives become forks, anything else is         
+/// pushed as it is                                                           
+///   @param data - the flow to emit                                          
+void Program::Emit(const Many& data) {
+   const bool fork = data.IsOr() and data.GetCount() > 1;
+   if (fork)
+      BeginFork();
+
+   if (data.IsDeep()) {
+      data.ForEach([&](const Many& group) {
+         if (fork)
+            BeginBranch();
+         Emit(group);
+      });
+   }
+   else if (data.Is<Verb>()) {
+      // Verbs are referenced in place, the program keeps them alive    
+      mData.emplace_back(data);
+      data.ForEach([&](const Verb& verb) {
+         if (fork)
+            BeginBranch();
+         Add(Instruction::Act).mVerb = &verb;
+      });
+   }
+   else {
+      if (fork)
+         BeginBranch();
+      Add(Instruction::Push).mData = mData.size();
+      mData.emplace_back(data);
+   }
+
+   if (fork)
+      EndFork();
+}
+
+/// Emit an idea that has no verbs                                            
+///   @param idea - the idea to mention                                       
+void Program::Emit(const Idea* idea) {
+   Add(Instruction::Mention).mIdea = idea;
+}
+
+/// Begin a fork of mutually exclusive branches                               
+/// Each branch must begin with BeginBranch, and the fork must be ended with  
+/// EndFork, after the last branch                                            
+void Program::BeginFork() {
+   mOpen.push_back({mCode.size()});
+   mDepth = ::std::max(mDepth, mOpen.size());
+   Add(Instruction::Fork);
+}
+
+/// Begin the next branch of the innermost fork                               
+void Program::BeginBranch() {
+   auto& open = mOpen.back();
+   if (open.mBranch != None) {
+      // The previous branch falls back to this one                     
+      EndBranch(open);
+      mCode[open.mBranch].mJump = static_cast<::std::uint32_t>(mCode.size() - open.mBranch);
+   }
+
+   open.mBranch = mCode.size();
+   Add(Instruction::Branch);
+}
+
+/// End a branch successfully. Joins of a fork are chained through their      
+/// data, until the end of the fork is known                                  
+///   @param open - the fork                                                  
+void Program::EndBranch(Open& open) {
+   const auto join = mCode.size();
+   Add(Instruction::Join).mData = open.mJoin;
+   open.mJoin = join;
+}
+
+/// End the innermost fork, and link its branches                             
+void Program::EndFork() {
+   auto open = mOpen.back();
+   mOpen.pop_back();
+   if (open.mBranch != None)
+      EndBranch(open);
+
+   // The last branch falls back to failing the whole fork              
+   const auto fail = mCode.size();
+   Add(Instruction::Fail);
+   const auto end = mCode.size();
+   if (open.mBranch != None)
+      mCode[open.mBranch].mJump = static_cast<::std::uint32_t>(fail - open.mBranch);
+
+   // All joins skip to the end of the fork                             
+   for (auto join = open.mJoin; join != None;) {
+      auto& op = mCode[join];
+      const auto previous = op.mData;
+      op.mJump = static_cast<::std::uint32_t>(end - join);
+      op.mData = 0;
+      join = previous;
+   }
+   mCode[open.mFork].mJump = static_cast<::std::uint32_t>(end - open.mFork);
+}
+
+/// Get the instructions                                                      
+///   @return the instructions                                                
+auto Program::GetCode() const noexcept -> const ::std::vector<Instruction>& {
+   return mCode;
+}
+
+/// Get data pushed by a Push instruction                                     
+///   @param index - the index of the data                                    
+///   @return the data                                                        
+auto Program::GetData(Offset index) const noexcept -> const Many& {
+   return mData[index];
+}
+
+/// Get the number of instructions                                            
+///   @return the number of instructions                                      
+auto Program::GetCount() const noexcept -> Count {
+   return mCode.size();
+}
@@ -0,0 +1,156 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <cstdint>
+#include <vector>
+
+struct Idea;
+
+
+///                                                                           
+///   A compiled flow, as a flat sequence of instructions                     
+///                                                                           
+/// An alternative to the nested scopes Mind::Compile produces. Every         
+/// instruction is a fixed-size record in a single contiguous array, and      
+/// mutually exclusive branches are linked with relative jumps, so running    
+/// a program never walks a hierarchy. Programs are meant to be reused -      
+/// clearing a program keeps its memory, so compiling into it again usually   
+/// doesn't allocate at all.                                                  
+///                                                                           
+///   Fork(end) Branch(next) ... Join(end) Branch(next) ... Join(end) Fail    
+///                                                                           
+/// Each branch is attempted in order, until one of them succeeds - then      
+/// its Join skips to the end of the fork. A failing instruction resumes at   
+/// the next branch of the innermost fork, and if none is left, Fail makes    
+/// the enclosing branch fail in turn.                                        
+///                                                                           
+struct Program {
+   /// A single instruction                                                   
+   struct Instruction {
+      enum Kind : ::std::uint8_t {
+         // Execute a verb                                              
+         Act,
+         // Mention an idea that has no verbs                           
+         Mention,
+         // Push data, as it is                                         
+         Push,
+         // Begin a fork of mutually exclusive branches                 
+         Fork,
+         // Begin a branch - jumps to the next branch on failure        
+         Branch,
+         // End a branch successfully - jumps to the end of the fork    
+         Join,
+         // No branch succeeded                                         
+         Fail
+      };
+
+      Kind mKind;
+      // Offset to the jump target, relative to this instruction        
+      ::std::uint32_t mJump = 0;
+      union {
+         const Verb* mVerb;
+         const Idea* mIdea;
+         Offset mData;
+      };
+   };
+
+   // Nesting of forks that can be run without allocating               
+   static constexpr Count MaxDepth = 64;
+
+private:
+   static constexpr Offset None = ~Offset {0};
+
+   /// A fork that is still being emitted                                     
+   struct Open {
+      Offset mFork;
+      // The last branch, and the last join, whose jumps are linked when
+      // the next branch begins, or when the fork ends                  
+      Offset mBranch = None;
+      Offset mJoin = None;
+   };
+
+   ::std::vector<Instruction> mCode;
+   // Operands that instructions refer to, kept alive by the program    
+   ::std::vector<Many> mData;
+   ::std::vector<Open> mOpen;
+   Count mDepth = 0;
+
+   auto Add(Instruction::Kind) -> Instruction&;
+   void EndBranch(Open&);
+
+public:
+   void Clear() noexcept;
+   void Reserve(Count);
+
+   void Emit(const Many&);
+   void Emit(const Idea*);
+   void BeginFork();
+   void BeginBranch();
+   void EndFork();
+
+   auto GetCode() const noexcept -> const ::std::vector<Instruction>&;
+   auto GetData(Offset) const noexcept -> const Many&;
+   auto GetCount() const noexcept -> Count;
+
+   /// Run the program                                                        
+   ///   @param call - function that executes a single instruction, invoked   
+   ///      with const Verb&, const Idea*, or const Many&, and returning      
+   ///      true on success                                                   
+   ///   @return true if the program ran to the end without failing           
+   template<class F>
+   bool Run(F&& call) const {
+      // Where to resume if the current branch fails                    
+      Offset local[MaxDepth];
+      ::std::vector<Offset> deep;
+      auto fallbacks = local;
+      if (mDepth > MaxDepth) {
+         deep.resize(mDepth);
+         fallbacks = deep.data();
+      }
+      Count depth = 0;
+
+      Offset pc = 0;
+      while (pc < mCode.size()) {
+         const auto& op = mCode[pc];
+         bool ok = true;
+         switch (op.mKind) {
+         case Instruction::Act:
+            ok = call(*op.mVerb);
+            break;
+         case Instruction::Mention:
+            ok = call(op.mIdea);
+            break;
+         case Instruction::Push:
+            ok = call(static_cast<const Many&>(mData[op.mData]));
+            break;
+         case Instruction::Fork:
+            break;
+         case Instruction::Branch:
+            fallbacks[depth++] = pc + op.mJump;
+            break;
+         case Instruction::Join:
+            --depth;
+            pc += op.mJump;
+            continue;
+         case Instruction::Fail:
+            ok = false;
+            break;
+         }
+
+         if (not ok) {
+            if (not depth)
+               return false;
+            pc = fallbacks[--depth];
+            continue;
+         }
+         ++pc;
+      }
+      return true;
+   }
+};
@@ -0,0 +1,469 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Snapshot.hpp"
+#include "Ontology.hpp"
+#include "Storage.hpp"
+#include <Langulus/Flow/Serial.hpp>
+#include <cstring>
+
+
+/// Serialize an idea descriptor to binary                                    
+///   @param descriptor - the descriptor to serialize                         
+///   @return the binary representation                                       
+auto EncodeDescriptor(const Many& descriptor) -> Bytes {
+   return Flow::Serialize<Bytes>(descriptor);
+}
+
+/// Deserialize an idea descriptor from binary                                
+///   @param raw - the start of the serialized descriptor                     
+///   @param size - number of bytes in the serialized descriptor              
+///   @return the descriptor                                                  
+auto DecodeDescriptor(const Byte* raw, Size size) -> Many {
+   const Bytes blob {raw, size};
+   Many descriptor;
+   blob.Deserialize(descriptor);
+   return descriptor;
+}
+
+/// Make a descriptor blob for data that isn't made of ideas                  
+///   @param data - the descriptor                                            
+///   @return the blob                                                        
+auto EncodeIdea(const Many& data) -> Bytes {
+   const SnapshotDescriptor head {SnapshotDescriptor::Data, 0};
+   const auto serialized = EncodeDescriptor(data);
+   ByteWriter blob;
+   blob.WritePOD(head);
+   blob.Write(serialized.GetRaw(), serialized.GetCount());
+   return blob.Finish();
+}
+
+/// Make a descriptor blob for a descriptor made of other ideas               
+///   @param parts - the indices of the ideas, in order                       
+///   @param alternatives - whether the ideas are mutually exclusive          
+///   @return the blob                                                        
+auto EncodeIdea(const ::std::vector<::std::uint32_t>& parts, bool alternatives) -> Bytes {
+   const SnapshotDescriptor head {
+      alternatives ? SnapshotDescriptor::Alternatives : SnapshotDescriptor::Sequence,
+      static_cast<::std::uint32_t>(parts.size())
+   };
+   ByteWriter blob;
+   blob.WritePOD(head);
+   blob.Write(parts.data(), parts.size() * sizeof(::std::uint32_t));
+   return blob.Finish();
+}
+
+/// Decode a descriptor blob - the indices of parts aren't validated here,    
+/// only the caller knows what they refer to                                  
+///   @param raw - the start of the blob                                      
+///   @param size - number of bytes in the blob                               
+///   @param idea - [out] the decoded descriptor                              
+///   @return false if the blob is malformed                                  
+bool DecodeIdea(const Byte* raw, Size size, DecodedIdea& idea) {
+   SnapshotDescriptor head;
+   if (size < sizeof(head))
+      return false;
+   ::std::memcpy(&head, raw, sizeof(head));
+
+   raw += sizeof(head);
+   size -= sizeof(head);
+   switch (head.mKind) {
+   case SnapshotDescriptor::Data:
+      idea.mKind = SnapshotDescriptor::Data;
+      idea.mData = DecodeDescriptor(raw, size);
+      idea.mParts.clear();
+      return true;
+   case SnapshotDescriptor::Sequence:
+   case SnapshotDescriptor::Alternatives:
+      if (head.mCount == 0 or size != head.mCount * Size {sizeof(::std::uint32_t)})
+         return false;
+      idea.mKind = static_cast<SnapshotDescriptor::Kind>(head.mKind);
+      idea.mData.Reset();
+      idea.mParts.resize(head.mCount);
+      ::std::memcpy(idea.mParts.data(), raw, size);
+      return true;
+   default:
+      return false;
+   }
+}
+
+/// Make the descriptor blob of an idea, referring to the ideas it is made of 
+/// by their index                                                            
+///   @param idea - the idea to encode                                        
+///   @param indices - the index of each idea, or nullptr to use the index    
+///      of each idea in this ontology                                        
+///   @param blob - [out] the descriptor blob                                 
+///   @return false if the idea is made of ideas that have no index           
+bool Ontology::Encode(const Idea& idea, const TUnorderedMap<const Idea*, ::std::uint32_t>* indices, Bytes& blob) const {
+   if (not idea.mDescriptor.Is<Idea>()) {
+      blob = EncodeIdea(idea.mDescriptor);
+      return true;
+   }
+
+   bool ok = true;
+   ::std::vector<::std::uint32_t> parts;
+   idea.mDescriptor.ForEach([&](const Idea& part) {
+      if (indices) {
+         const auto found = indices->FindIt(&part);
+         if (found) {
+            parts.push_back(found.GetValue());
+            return Loop::Continue;
+         }
+      }
+      else if (part.GetOntology() == this) {
+         parts.push_back(static_cast<::std::uint32_t>(part.mIndex));
+         return Loop::Continue;
+      }
+
+      Logger::Error(Self(), "Idea ", idea, " is made of ", part,
+         ", that can't be referred to by index");
+      ok = false;
+      return Loop::Break;
+   });
+
+   if (ok)
+      blob = EncodeIdea(parts, idea.mDescriptor.IsOr());
+   return ok;
+}
+
+/// Save the ontology as a binary snapshot, that can later be memory mapped   
+/// and loaded without reinterpreting any of the definitions                  
+///   @param path - the file to write                                         
+///   @return true if the snapshot was written successfully                   
+bool Ontology::Save(const Text& path) const {
+   FileWriter file;
+   if (not file.Open(path)) {
+      Logger::Error(Self(), "Can't open `", path, "` for writing a snapshot");
+      return false;
+   }
+
+   // Ideas are written in order of their indices, so that their index  
+   // in the snapshot matches Idea::mIndex, and a journal can continue  
+   // from it. The image is synchronized, so it can be swapped in safely
+   if (not WriteImage(file, mOrder) or not file.Flush()) {
+      Logger::Error(Self(), "Failed writing snapshot `", path, '`');
+      return false;
+   }
+
+   VERBOSE_AI("Saved ", mOrder.GetCount(), " ideas to `", path, '`');
+   return true;
+}
+
+/// Save the ontology as a binary snapshot in memory, in the same format as   
+/// the snapshot files                                                        
+///   @return the snapshot image, or nothing if it couldn't be made           
+auto Ontology::Save() const -> Bytes {
+   ByteWriter image;
+   if (not WriteImage(image, mOrder)) {
+      Logger::Error(Self(), "Failed making a snapshot image");
+      return {};
+   }
+
+   return image.Finish();
+}
+
+/// Write a snapshot image of a set of ideas                                  
+///   @tparam WRITER - where to write, either a FileWriter or a ByteWriter    
+///   @param file - the file to write the image to                            
+///   @param ideas - the ideas to write, edges and the ideas that descriptors 
+///      are made of must not leave this set                                  
+///   @return true if the image was written successfully                      
+template<class WRITER>
+bool Ontology::WriteImage(WRITER& file, const Ideas& ideas) const {
+   TUnorderedMap<const Idea*, ::std::uint32_t> indices;
+   for (auto idea : ideas)
+      indices.Insert(idea, static_cast<::std::uint32_t>(indices.GetCount()));
+
+   bool ok = true;
+   TMany<Bytes> blobs;
+   ::std::uint64_t edgeCount = 0;
+   ::std::uint64_t blobsSize = 0;
+   for (auto idea : ideas) {
+      Bytes blob;
+      ok &= Encode(*idea, &indices, blob);
+      blobs << blob;
+      blobsSize += AlignSection(blob.GetCount());
+      edgeCount += idea->mAssociations.Latest().GetCount()
+                 + idea->mDisassociations.Latest().GetCount();
+   }
+
+   SnapshotHeader header {};
+   ::std::memcpy(header.mMagic, SnapshotHeader::Magic, sizeof(header.mMagic));
+   header.mVersion = SnapshotHeader::CurrentVersion;
+   header.mEndianness = SnapshotHeader::NativeEndianness;
+   header.mIdeaCount = ideas.GetCount();
+   header.mEdgeCount = edgeCount;
+   header.mLongestKnownText = mLongestKnownText;
+   header.mIdeasOffset = sizeof(SnapshotHeader);
+   header.mEdgesOffset = header.mIdeasOffset
+                       + header.mIdeaCount * sizeof(SnapshotIdea);
+   header.mBlobsOffset = header.mEdgesOffset
+                       + header.mEdgeCount * sizeof(SnapshotEdge);
+   header.mBlobsSize = blobsSize;
+   header.mGeneration = mGeneration;
+
+   ok &= file.WritePOD(header);
+
+   // Write the idea table                                              
+   ::std::uint64_t blobOffset = 0;
+   for (Offset i = 0; i < ideas.GetCount(); ++i) {
+      SnapshotIdea record {};
+      record.mBlobOffset = blobOffset;
+      record.mBlobSize = blobs[i].GetCount();
+      record.mRating = static_cast<double>(ideas[i]->mRating);
+      ok &= file.WritePOD(record);
+      blobOffset += AlignSection(record.mBlobSize);
+   }
+
+   // Write the edge table, preserving the order of links               
+   const auto writeEdges = [&](const Idea* from, const Links::View& to, auto kind) {
+      for (auto idea : to) {
+         const auto found = indices.FindIt(idea);
+         if (not found) {
+            Logger::Error(Self(), "Idea ", *idea, " is linked, but is not "
+               "part of the image - image will be incomplete");
+            ok = false;
+            continue;
+         }
+
+         SnapshotEdge edge {};
+         edge.mFrom = indices[from];
+         edge.mTo = found.GetValue();
+         edge.mKind = kind;
+         ok &= file.WritePOD(edge);
+      }
+   };
+
+   for (auto idea : ideas) {
+      writeEdges(idea, idea->mAssociations.Latest(), SnapshotEdge::Association);
+      writeEdges(idea, idea->mDisassociations.Latest(), SnapshotEdge::Disassociation);
+   }
+
+   // Write the descriptors                                             
+   constexpr Byte padding[8] {};
+   for (auto& blob : blobs) {
+      ok &= file.Write(blob.GetRaw(), blob.GetCount());
+      ok &= file.Write(padding, AlignSection(blob.GetCount()) - blob.GetCount());
+   }
+
+   return ok;
+}
+
+template bool Ontology::WriteImage(FileWriter&, const Ideas&) const;
+template bool Ontology::WriteImage(ByteWriter&, const Ideas&) const;
+
+/// Map a binary snapshot file and load it into the ontology                  
+///   @param path - the snapshot file                                         
+///   @return true if the snapshot was loaded successfully                    
+bool Ontology::Load(const Text& path) {
+   MappedFile file;
+   if (not file.Open(path)) {
+      Logger::Error(Self(), "Can't map snapshot `", path, '`');
+      return false;
+   }
+
+   return Load(file.GetRaw(), file.GetSize());
+}
+
+/// Load a binary snapshot image into the ontology. Ideas that are already    
+/// known are reused, so loading can also be used to merge ontologies.        
+/// A persistent ontology is compacted afterwards, as if loaded from its base 
+///   @param raw - the start of the snapshot image                            
+///   @param size - the size of the snapshot image in bytes                   
+///   @return true if the image was loaded successfully                       
+bool Ontology::Load(const Byte* raw, Size size) {
+   Ideas loaded;
+   if (not LoadImage(raw, size, loaded))
+      return false;
+
+   // Neither the links, nor the order of the loaded ideas are journaled,
+   // so a persistent ontology is compacted right away instead          
+   if (mJournal.IsOpen()) {
+      const Text journal = mJournal.GetPath();
+      return Compact(journal);
+   }
+   return true;
+}
+
+/// Read a record from a table, that might not be aligned in memory           
+///   @param table - the start of the table                                   
+///   @param index - the index of the record                                  
+///   @return a copy of the record                                            
+template<class T>
+auto ReadRecord(const Byte* table, ::std::uint64_t index) noexcept -> T {
+   T record;
+   ::std::memcpy(&record, table + index * sizeof(T), sizeof(T));
+   return record;
+}
+
+/// Load a binary snapshot image into the ontology                            
+/// The whole image is validated and decoded before any idea is created, so   
+/// that a corrupt image leaves the ontology unchanged                        
+///   @param raw - the start of the snapshot image                            
+///   @param size - the size of the snapshot image in bytes                   
+///   @param ideas - [out] the ideas, in the order they appear in the image   
+///   @return true if the image was loaded successfully                       
+bool Ontology::LoadImage(const Byte* raw, Size size, Ideas& ideas) {
+   if (not raw or size < sizeof(SnapshotHeader)) {
+      Logger::Error(Self(), "Snapshot is too small");
+      return false;
+   }
+
+   SnapshotHeader header;
+   ::std::memcpy(&header, raw, sizeof(header));
+   if (::std::memcmp(header.mMagic, SnapshotHeader::Magic, sizeof(header.mMagic))
+   or  header.mEndianness != SnapshotHeader::NativeEndianness) {
+      Logger::Error(Self(), "Not an ontology snapshot, "
+         "or snapshot was made on an incompatible platform");
+      return false;
+   }
+
+   if (header.mVersion != SnapshotHeader::CurrentVersion) {
+      Logger::Error(Self(), "Unsupported snapshot version ", header.mVersion,
+         " (expected ", SnapshotHeader::CurrentVersion, ')');
+      return false;
+   }
+
+   if (not Fits(header.mIdeasOffset, header.mIdeaCount, sizeof(SnapshotIdea), size)
+   or  not Fits(header.mEdgesOffset, header.mEdgeCount, sizeof(SnapshotEdge), size)
+   or  not Fits(header.mBlobsOffset, header.mBlobsSize, 1, size)) {
+      Logger::Error(Self(), "Snapshot is truncated");
+      return false;
+   }
+
+   const auto ideaTable = raw + header.mIdeasOffset;
+   const auto edgeTable = raw + header.mEdgesOffset;
+   const auto blobs = raw + header.mBlobsOffset;
+
+   // Validate all links first                                          
+   for (::std::uint64_t i = 0; i < header.mEdgeCount; ++i) {
+      const auto edge = ReadRecord<SnapshotEdge>(edgeTable, i);
+      if (edge.mFrom >= header.mIdeaCount or edge.mTo >= header.mIdeaCount
+      or (edge.mKind != SnapshotEdge::Association
+      and edge.mKind != SnapshotEdge::Disassociation)) {
+         Logger::Error(Self(), "Snapshot link #", i, " is out of bounds");
+         return false;
+      }
+   }
+
+   // Then decode all descriptors                                       
+   ::std::vector<DecodedIdea> descriptors(header.mIdeaCount);
+   TMany<Rating> ratings;
+   ratings.Reserve(header.mIdeaCount);
+   for (::std::uint64_t i = 0; i < header.mIdeaCount; ++i) {
+      const auto record = ReadRecord<SnapshotIdea>(ideaTable, i);
+      if (not Fits(record.mBlobOffset, record.mBlobSize, 1, header.mBlobsSize)
+      or  not DecodeIdea(blobs + record.mBlobOffset, record.mBlobSize, descriptors[i])) {
+         Logger::Error(Self(), "Snapshot idea #", i, " is out of bounds");
+         return false;
+      }
+
+      ratings << static_cast<Rating>(record.mRating);
+   }
+
+   // Ideas can be made of ideas anywhere in the image, so they are     
+   // instantiated after their parts. Parts must be in the image, and   
+   // ideas can't be made of themselves. The parts are walked with an   
+   // explicit stack, so that a corrupt image can't overflow the call one
+   enum Visit : ::std::uint8_t { Unvisited, Visiting, Visited };
+   ::std::vector<Visit> visits(header.mIdeaCount, Unvisited);
+   ::std::vector<::std::uint32_t> order;
+   ::std::vector<::std::pair<::std::uint32_t, Offset>> stack;
+   order.reserve(header.mIdeaCount);
+   for (::std::uint32_t root = 0; root < header.mIdeaCount; ++root) {
+      if (visits[root] != Unvisited)
+         continue;
+
+      visits[root] = Visiting;
+      stack.emplace_back(root, 0);
+      while (not stack.empty()) {
+         auto& [i, next] = stack.back();
+         const auto& parts = descriptors[i].mParts;
+         if (next == parts.size()) {
+            visits[i] = Visited;
+            order.push_back(i);
+            stack.pop_back();
+            continue;
+         }
+
+         const auto part = parts[next++];
+         if (part >= header.mIdeaCount or visits[part] == Visiting) {
+            Logger::Error(Self(), "Snapshot idea #", i, " is made of "
+               "ideas that are missing, or made of itself");
+            return false;
+         }
+
+         if (visits[part] == Unvisited) {
+            visits[part] = Visiting;
+            stack.emplace_back(part, 0);
+         }
+      }
+   }
+
+   // Only now instantiate the ideas, the image can't fail anymore      
+   const auto before = mOrder.GetCount();
+   ::std::vector<Idea*> spawned(header.mIdeaCount);
+   for (auto i : order) {
+      const auto& descriptor = descriptors[i];
+      Idea* idea;
+      if (descriptor.mKind == SnapshotDescriptor::Data)
+         idea = Spawn(descriptor.mData);
+      else {
+         Ideas parts;
+         if (descriptor.mKind == SnapshotDescriptor::Alternatives)
+            parts.MakeOr();
+         for (auto part : descriptor.mParts)
+            parts << spawned[part];
+         idea = Spawn(parts);
+      }
+
+      idea->mRating = ratings[i];
+      spawned[i] = idea;
+   }
+
+   const auto first = ideas.GetCount();
+   ideas.Reserve(first + spawned.size());
+   for (auto idea : spawned)
+      ideas << idea;
+
+   // Parts might have been instantiated before the ideas made of them, 
+   // so the new ideas are put back in the order of the image - this    
+   // way the index of each idea matches the image, when it is a base   
+   // that journals continue from                                       
+   Offset next = before;
+   for (Offset i = first; i < ideas.GetCount(); ++i) {
+      auto idea = ideas[i];
+      if (idea->mIndex < next)
+         continue;
+
+      const auto displaced = mOrder[next];
+      mOrder[idea->mIndex] = displaced;
+      displaced->mIndex = idea->mIndex;
+      mOrder[next] = idea;
+      idea->mIndex = next++;
+   }
+
+   // Restore links, bypassing Idea::LinkIdea - it's already known that 
+   // the ideas are from this ontology, and symmetry is already baked   
+   for (::std::uint64_t i = 0; i < header.mEdgeCount; ++i) {
+      const auto edge = ReadRecord<SnapshotEdge>(edgeTable, i);
+      auto from = ideas[first + edge.mFrom];
+      auto to = ideas[first + edge.mTo];
+      if (edge.mKind == SnapshotEdge::Association)
+         AddLink(from->mAssociations, to);
+      else
+         AddLink(from->mDisassociations, to);
+   }
+
+   if (header.mLongestKnownText > mLongestKnownText)
+      mLongestKnownText = static_cast<Count>(header.mLongestKnownText);
+
+   mCache.Clear();
+   VERBOSE_AI("Loaded ", header.mIdeaCount, " ideas and ",
+      header.mEdgeCount, " links from snapshot");
+   return true;
+}
@@ -0,0 +1,122 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <Langulus/Anyness/Bytes.hpp>
+#include <cstdint>
+#include <vector>
+
+
+///                                                                           
+///   Binary ontology snapshot layout                                         
+///                                                                           
+/// A snapshot is a flat, position-independent image, designed to be mapped   
+/// into memory and consumed in place, without any text parsing:              
+///                                                                           
+///   [SnapshotHeader]                                                        
+///   [SnapshotIdea  x header.mIdeaCount]                                     
+///   [SnapshotEdge  x header.mEdgeCount]                                     
+///   [descriptor blobs, referenced by offset from each SnapshotIdea]         
+///                                                                           
+/// All sections are 8-byte aligned and in native byte order. Ideas are       
+/// referred to by their index in the idea table. Edges are directed and      
+/// are stored in the order they appear in each idea's (dis)associations,     
+/// so that loading restores exactly the same graph.                          
+/// Descriptors made of other ideas refer to their parts by index as well,    
+/// so an image never contains pointers, and parts are always part of it.     
+///                                                                           
+struct SnapshotHeader {
+   static constexpr char Magic[8] = {'L','G','L','S','O','N','T','O'};
+   static constexpr ::std::uint32_t CurrentVersion = 3;
+   static constexpr ::std::uint32_t NativeEndianness = 0x01020304;
+
+   char            mMagic[8];
+   ::std::uint32_t mVersion;
+   ::std::uint32_t mEndianness;
+   ::std::uint64_t mIdeaCount;
+   ::std::uint64_t mEdgeCount;
+   ::std::uint64_t mLongestKnownText;
+   ::std::uint64_t mIdeasOffset;
+   ::std::uint64_t mEdgesOffset;
+   ::std::uint64_t mBlobsOffset;
+   ::std::uint64_t mBlobsSize;
+   // Generation of the journal that continues from this image          
+   ::std::uint64_t mGeneration;
+};
+
+struct SnapshotIdea {
+   ::std::uint64_t mBlobOffset;
+   ::std::uint64_t mBlobSize;
+   double          mRating;
+};
+
+struct SnapshotEdge {
+   enum Kind : ::std::uint32_t {
+      Association = 0,
+      Disassociation = 1
+   };
+
+   ::std::uint32_t mFrom;
+   ::std::uint32_t mTo;
+   ::std::uint32_t mKind;
+   ::std::uint32_t mReserved;
+};
+
+/// Every descriptor blob in a snapshot or a journal starts with this, and    
+/// is followed either by the serialized data, or by mCount 32-bit indices    
+/// of the ideas the descriptor is made of                                    
+struct SnapshotDescriptor {
+   enum Kind : ::std::uint32_t {
+      // Anything that isn't made of ideas                              
+      Data = 0,
+      // A sequence of ideas                                            
+      Sequence = 1,
+      // Mutually exclusive ideas                                       
+      Alternatives = 2
+   };
+
+   ::std::uint32_t mKind;
+   ::std::uint32_t mCount;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0);
+static_assert(sizeof(SnapshotIdea) % 8 == 0);
+static_assert(sizeof(SnapshotEdge) % 8 == 0);
+static_assert(sizeof(SnapshotDescriptor) % 8 == 0);
+
+/// Round a size up to the alignment of snapshot and journal sections         
+///   @param size - the size to align                                         
+///   @return the aligned size                                                
+constexpr ::std::uint64_t AlignSection(::std::uint64_t size) noexcept {
+   return (size + 7) & ~::std::uint64_t {7};
+}
+
+/// Check if a table of records fits inside a region, without overflowing     
+///   @param offset - where the table starts in the region                    
+///   @param count - number of records in the table                           
+///   @param stride - size of a single record                                 
+///   @param size - size of the region                                        
+///   @return true if the whole table is inside the region                    
+constexpr bool Fits(::std::uint64_t offset, ::std::uint64_t count, ::std::uint64_t stride, ::std::uint64_t size) noexcept {
+   return offset <= size and count <= (size - offset) / stride;
+}
+
+/// A decoded descriptor blob                                                 
+struct DecodedIdea {
+   // The descriptor, if it isn't made of ideas                         
+   Many mData;
+   // Indices of the ideas the descriptor is made of, if it is          
+   ::std::vector<::std::uint32_t> mParts;
+   SnapshotDescriptor::Kind mKind = SnapshotDescriptor::Data;
+};
+
+auto EncodeDescriptor(const Many&) -> Bytes;
+auto DecodeDescriptor(const Byte*, Size) -> Many;
+auto EncodeIdea(const Many&) -> Bytes;
+auto EncodeIdea(const ::std::vector<::std::uint32_t>&, bool alternatives) -> Bytes;
+bool DecodeIdea(const Byte*, Size, DecodedIdea&);
@@ -0,0 +1,317 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Storage.hpp"
+
+#if LANGULUS_OS(WINDOWS)
+   #define WIN32_LEAN_AND_MEAN
+   #define NOMINMAX
+   #include <Windows.h>
+   #include <io.h>
+#else
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
+
+/// Convert a Langulus text to a null-terminated native path                  
+///   @param path - the path to convert                                       
+///   @return the native path                                                 
+auto MappedFile::Path(const Text& path) -> ::std::string {
+   return ::std::string {
+      reinterpret_cast<const char*>(path.GetRaw()), path.GetCount()
+   };
+}
+
+/// Move-construct a mapping                                                  
+///   @param other - the mapping to move                                      
+MappedFile::MappedFile(MappedFile&& other) noexcept
+   : mData    {other.mData}
+   , mSize    {other.mSize}
+#if LANGULUS_OS(WINDOWS)
+   , mFile    {other.mFile}
+   , mMapping {other.mMapping} {
+   other.mFile = other.mMapping = nullptr;
+#else
+   , mFile    {other.mFile} {
+   other.mFile = -1;
+#endif
+   other.mData = nullptr;
+   other.mSize = 0;
+}
+
+/// Unmap on destruction                                                      
+MappedFile::~MappedFile() {
+   Close();
+}
+
+/// Move-assign a mapping                                                     
+///   @param other - the mapping to move                                      
+///   @return a reference to this mapping                                     
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept {
+   if (this == &other)
+      return *this;
+
+   Close();
+   mData = other.mData;
+   mSize = other.mSize;
+   mFile = other.mFile;
+#if LANGULUS_OS(WINDOWS)
+   mMapping = other.mMapping;
+   other.mFile = other.mMapping = nullptr;
+#else
+   other.mFile = -1;
+#endif
+   other.mData = nullptr;
+   other.mSize = 0;
+   return *this;
+}
+
+/// Map a whole file into memory for reading                                  
+///   @param path - the file to map                                           
+///   @return true if the file was mapped successfully                        
+bool MappedFile::Open(const Text& path) {
+   Close();
+   const auto native = Path(path);
+
+#if LANGULUS_OS(WINDOWS)
+   mFile = ::CreateFileA(native.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (mFile == INVALID_HANDLE_VALUE) {
+      mFile = nullptr;
+      return false;
+   }
+
+   LARGE_INTEGER size;
+   if (not ::GetFileSizeEx(mFile, &size) or size.QuadPart == 0) {
+      Close();
+      return false;
+   }
+
+   mMapping = ::CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if (not mMapping) {
+      Close();
+      return false;
+   }
+
+   mData = static_cast<const Byte*>(
+      ::MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+   mSize = static_cast<Size>(size.QuadPart);
+#else
+   mFile = ::open(native.c_str(), O_RDONLY);
+   if (mFile < 0)
+      return false;
+
+   struct stat info;
+   if (::fstat(mFile, &info) != 0 or info.st_size == 0) {
+      Close();
+      return false;
+   }
+
+   auto mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size),
+      PROT_READ, MAP_PRIVATE, mFile, 0);
+   if (mapped == MAP_FAILED) {
+      Close();
+      return false;
+   }
+
+   mData = static_cast<const Byte*>(mapped);
+   mSize = static_cast<Size>(info.st_size);
+#endif
+
+   if (not mData) {
+      Close();
+      return false;
+   }
+   return true;
+}
+
+/// Release the mapping and the file handle                                   
+void MappedFile::Close() {
+#if LANGULUS_OS(WINDOWS)
+   if (mData)
+      ::UnmapViewOfFile(mData);
+   if (mMapping)
+      ::CloseHandle(mMapping);
+   if (mFile)
+      ::CloseHandle(mFile);
+   mMapping = mFile = nullptr;
+#else
+   if (mData)
+      ::munmap(const_cast<Byte*>(mData), mSize);
+   if (mFile >= 0)
+      ::close(mFile);
+   mFile = -1;
+#endif
+   mData = nullptr;
+   mSize = 0;
+}
+
+/// Get the mapped memory                                                     
+///   @return a pointer to the start of the file                              
+auto MappedFile::GetRaw() const noexcept -> const Byte* {
+   return mData;
+}
+
+/// Get the size of the mapped memory                                         
+///   @return the size of the file in bytes                                   
+auto MappedFile::GetSize() const noexcept -> Size {
+   return mSize;
+}
+
+/// Check if a file is mapped                                                 
+MappedFile::operator bool() const noexcept {
+   return mData != nullptr;
+}
+
+
+/// Close the file on destruction                                             
+FileWriter::~FileWriter() {
+   Close();
+}
+
+/// Open a file for binary writing                                            
+///   @param path - the file to write to                                      
+///   @param append - whether to append, or to truncate the file              
+///   @return true if the file was opened successfully                        
+bool FileWriter::Open(const Text& path, bool append) {
+   Close();
+   mFile = ::std::fopen(MappedFile::Path(path).c_str(), append ? "ab" : "wb");
+   mWritten = 0;
+   return mFile != nullptr;
+}
+
+/// Close the file, flushing any buffered data                                
+void FileWriter::Close() {
+   if (mFile) {
+      ::std::fclose(mFile);
+      mFile = nullptr;
+   }
+}
+
+/// Write raw bytes at the end of the file                                    
+///   @param data - the bytes to write                                        
+///   @param size - the number of bytes to write                              
+///   @return true if all bytes were written                                  
+bool FileWriter::Write(const void* data, Size size) {
+   if (not mFile)
+      return false;
+   if (not size)
+      return true;
+
+   const auto written = ::std::fwrite(data, 1, size, mFile);
+   mWritten += written;
+   return written == size;
+}
+
+/// Push everything written so far to the storage device, so that it          
+/// survives a crash of the process                                           
+///   @return true if the data was synchronized                               
+bool FileWriter::Flush() {
+   if (not mFile or ::std::fflush(mFile) != 0)
+      return false;
+
+#if LANGULUS_OS(WINDOWS)
+   return ::_commit(::_fileno(mFile)) == 0;
+#else
+   return ::fsync(::fileno(mFile)) == 0;
+#endif
+}
+
+/// Get the number of bytes written since the file was opened                 
+///   @return the number of bytes                                             
+auto FileWriter::GetWritten() const noexcept -> Size {
+   return mWritten;
+}
+
+/// Check if a file is opened                                                 
+FileWriter::operator bool() const noexcept {
+   return mFile != nullptr;
+}
+
+
+/// Append raw bytes                                                          
+///   @param data - the bytes to write                                        
+///   @param size - the number of bytes to write                              
+///   @return true                                                            
+bool ByteWriter::Write(const void* data, Size size) {
+   const auto bytes = static_cast<const Byte*>(data);
+   mData.insert(mData.end(), bytes, bytes + size);
+   return true;
+}
+
+/// Get the number of bytes written so far                                    
+///   @return the number of bytes                                             
+auto ByteWriter::GetWritten() const noexcept -> Size {
+   return mData.size();
+}
+
+/// Get the bytes written so far                                              
+///   @return a pointer to the first byte                                     
+auto ByteWriter::GetRaw() const noexcept -> const Byte* {
+   return mData.data();
+}
+
+/// Get everything written, and start over                                    
+///   @return the written bytes                                               
+auto ByteWriter::Finish() -> Bytes {
+   Bytes result {mData.data(), mData.size()};
+   mData.clear();
+   return result;
+}
+
+
+/// Make changes to the entries of the folder containing a file durable, so   
+/// that a rename or removal survives a crash of the system                   
+///   @param path - the native path of the file                               
+///   @return true if the folder was synchronized                             
+static bool SyncFolderOf(const ::std::string& path) {
+#if LANGULUS_OS(WINDOWS)
+   // Windows makes renames durable with MOVEFILE_WRITE_THROUGH instead 
+   (void) path;
+   return true;
+#else
+   const auto slash = path.find_last_of('/');
+   const auto folder = slash == ::std::string::npos ? ::std::string {"."}
+                     : slash == 0 ? ::std::string {"/"}
+                     : path.substr(0, slash);
+   const int handle = ::open(folder.c_str(), O_RDONLY);
+   if (handle < 0)
+      return false;
+
+   const bool synced = ::fsync(handle) == 0;
+   ::close(handle);
+   return synced;
+#endif
+}
+
+/// Atomically replace a file with another one, and make the replacement      
+/// durable - after a crash either the old or the new file is found           
+///   @attention the source file must already be synchronized                 
+///   @param source - the file to move                                        
+///   @param target - the file to replace                                     
+///   @return true if the file was replaced                                   
+bool ReplaceFile(const Text& source, const Text& target) {
+   const auto from = MappedFile::Path(source);
+   const auto to = MappedFile::Path(target);
+#if LANGULUS_OS(WINDOWS)
+   return ::MoveFileExA(from.c_str(), to.c_str(),
+      MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+   return ::rename(from.c_str(), to.c_str()) == 0 and SyncFolderOf(to);
+#endif
+}
+
+/// Durably remove a file                                                     
+///   @param path - the file to remove                                        
+///   @return true if the file was removed                                    
+bool RemoveFile(const Text& path) {
+   const auto native = MappedFile::Path(path);
+   return ::std::remove(native.c_str()) == 0 and SyncFolderOf(native);
+}
@@ -0,0 +1,110 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <Langulus/Anyness/Bytes.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+
+///                                                                           
+///   Read-only memory mapped file                                            
+///                                                                           
+/// Used for loading persistent images (ontology snapshots, etc.) without     
+/// copying them through intermediate buffers. The mapping is released when   
+/// the instance is destroyed, so anything that points inside the mapped      
+/// region must not outlive it.                                               
+///                                                                           
+struct MappedFile {
+private:
+   const Byte* mData = nullptr;
+   Size mSize = 0;
+#if LANGULUS_OS(WINDOWS)
+   void* mFile = nullptr;
+   void* mMapping = nullptr;
+#else
+   int mFile = -1;
+#endif
+
+public:
+   MappedFile() = default;
+   MappedFile(const MappedFile&) = delete;
+   MappedFile(MappedFile&&) noexcept;
+   ~MappedFile();
+
+   MappedFile& operator = (const MappedFile&) = delete;
+   MappedFile& operator = (MappedFile&&) noexcept;
+
+   bool Open(const Text&);
+   void Close();
+
+   auto GetRaw() const noexcept -> const Byte*;
+   auto GetSize() const noexcept -> Size;
+   explicit operator bool() const noexcept;
+
+   static auto Path(const Text&) -> ::std::string;
+};
+
+
+///                                                                           
+///   Sequential binary file writer                                           
+///                                                                           
+struct FileWriter {
+private:
+   ::std::FILE* mFile = nullptr;
+   Size mWritten = 0;
+
+public:
+   FileWriter() = default;
+   FileWriter(const FileWriter&) = delete;
+   ~FileWriter();
+
+   bool Open(const Text&, bool append = false);
+   void Close();
+
+   bool Write(const void*, Size);
+   bool Flush();
+
+   auto GetWritten() const noexcept -> Size;
+   explicit operator bool() const noexcept;
+
+   /// Write a plain data structure as it is in memory                        
+   ///   @param data - the data to write                                      
+   ///   @return true if the data was written completely                      
+   template<class T> requires ::std::is_trivially_copyable_v<T>
+   bool WritePOD(const T& data) {
+      return Write(&data, sizeof(T));
+   }
+};
+
+
+///                                                                           
+///   Sequential writer into memory, with the same interface as FileWriter    
+///                                                                           
+struct ByteWriter {
+private:
+   ::std::vector<Byte> mData;
+
+public:
+   bool Write(const void*, Size);
+   auto GetWritten() const noexcept -> Size;
+   auto GetRaw() const noexcept -> const Byte*;
+   auto Finish() -> Bytes;
+
+   /// Write a plain data structure as it is in memory                        
+   ///   @param data - the data to write                                      
+   ///   @return true                                                         
+   template<class T> requires ::std::is_trivially_copyable_v<T>
+   bool WritePOD(const T& data) {
+      return Write(&data, sizeof(T));
+   }
+};
+
+bool ReplaceFile(const Text& source, const Text& target);
+bool RemoveFile(const Text&);
@@ -0,0 +1,40 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Thought.hpp"
+
+
+/// Begin thinking about some text                                            
+///   @param text - the text to interpret                                     
+Thought::Thought(const Text& text)
+   : mText {Clone(text)}
+   , mInterpretation {mText} {}
+
+/// Get the text being interpreted                                            
+///   @return the text                                                        
+auto Thought::GetText() const noexcept -> const Text& {
+   return mText;
+}
+
+/// Get how far the interpretation has progressed                             
+///   @return the stage                                                       
+auto Thought::GetStage() const noexcept -> Stage {
+   return mStage;
+}
+
+/// Check if the interpretation has completed                                 
+///   @return true if the result is available                                 
+bool Thought::IsDone() const noexcept {
+   return mStage == Stage::Done;
+}
+
+/// Get the compiled actions                                                  
+///   @attention only valid after IsDone() returns true                       
+///   @return the interpreted and compiled text                               
+auto Thought::GetResult() const noexcept -> const Many& {
+   return mResult;
+}
@@ -0,0 +1,51 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "Ontology.hpp"
+#include <atomic>
+
+
+///                                                                           
+///   A pending interpretation                                                
+///                                                                           
+/// Interpreting text is resumable - suffixes of the text are interpreted     
+/// from the shortest to the longest, each one prefix at a time, and every    
+/// completed suffix is cached by the ontology. That way every step is short, 
+/// because it reuses the interpretations of all shorter suffixes, and the    
+/// mind can stop thinking between any two steps, to resume on the next       
+/// update.                                                                   
+///                                                                           
+/// Thoughts also serve as handles to interpretations running in the          
+/// background, that are polled until they are done.                          
+///                                                                           
+struct Thought {
+   enum class Stage {
+      Interpreting,
+      Compiling,
+      Done
+   };
+
+private:
+   friend struct Mind;
+
+   // The text being interpreted                                        
+   Text mText;
+   // Progress of interpreting it, if done gradually                    
+   Ontology::Interpretation mInterpretation;
+   // Ideas found in the text, and later - the compiled actions         
+   Many mResult;
+   ::std::atomic<Stage> mStage = Stage::Interpreting;
+
+public:
+   Thought(const Text&);
+
+   auto GetText() const noexcept -> const Text&;
+   auto GetStage() const noexcept -> Stage;
+   bool IsDone() const noexcept;
+   auto GetResult() const noexcept -> const Many&;
+};
@@ -0,0 +1,165 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Trace.hpp"
+#include "Storage.hpp"
+#include <algorithm>
+
+#if LANGULUS_MOD_AI_TRACE
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+   /// A finished span                                                        
+   struct Event {
+      const char* mName;
+      ::std::uint64_t mStart;
+      ::std::uint64_t mDuration;
+   };
+
+   /// Ring buffer of the spans of a single thread. The lock is only ever     
+   /// contended while dumping                                                
+   struct Shard {
+      ::std::mutex mMutex;
+      ::std::vector<Event> mEvents;
+      Offset mHead = 0;
+      Count mRecorded = 0;
+      Offset mThread = 0;
+   };
+
+   /// All shards ever created. Shards outlive their threads, so that the     
+   /// spans of finished threads can still be dumped, and are never moved     
+   struct Registry {
+      ::std::mutex mMutex;
+      ::std::deque<Shard> mShards;
+      ::std::chrono::steady_clock::time_point mOrigin = ::std::chrono::steady_clock::now();
+   };
+
+   auto GetRegistry() -> Registry& {
+      static Registry registry;
+      return registry;
+   }
+
+   /// Get the shard of the current thread, registering it the first time     
+   auto GetShard() -> Shard& {
+      thread_local Shard* shard = [] {
+         auto& registry = GetRegistry();
+         const ::std::lock_guard lock {registry.mMutex};
+         auto& created = registry.mShards.emplace_back();
+         created.mEvents.resize(Trace::Capacity);
+         created.mThread = registry.mShards.size();
+         return &created;
+      }();
+      return *shard;
+   }
+
+   /// Nanoseconds since the registry was created                             
+   auto Now() -> ::std::uint64_t {
+      return static_cast<::std::uint64_t>(
+         ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            ::std::chrono::steady_clock::now() - GetRegistry().mOrigin).count());
+   }
+}
+
+/// Begin a span                                                              
+///   @param name - name of the span, must be a string literal                
+Trace::Span::Span(const char* name) noexcept
+   : mName {name}
+   , mStart {Now()} {}
+
+/// End the span, and record it in the ring buffer of the current thread      
+Trace::Span::~Span() {
+   const auto end = Now();
+   auto& shard = GetShard();
+   const ::std::lock_guard lock {shard.mMutex};
+   shard.mEvents[shard.mHead] = {mName, mStart, end - mStart};
+   shard.mHead = (shard.mHead + 1) % Capacity;
+   ++shard.mRecorded;
+}
+
+/// Write all recorded spans in the Chrome trace event format                 
+///   @param path - the file to write to                                      
+///   @return true if the file was written                                    
+bool Trace::Dump(const Text& path) {
+   FileWriter file;
+   if (not file.Open(path)) {
+      Logger::Error("Can't open `", path, "` for dumping traces");
+      return false;
+   }
+
+   auto& registry = GetRegistry();
+   const ::std::lock_guard lock {registry.mMutex};
+   static constexpr char Header[] = "{\"traceEvents\":[";
+   static constexpr char Footer[] = "\n],\"displayTimeUnit\":\"ns\"}\n";
+   bool ok = file.Write(Header, sizeof(Header) - 1);
+   bool first = true;
+   char line[256];
+
+   for (auto& shard : registry.mShards) {
+      const ::std::lock_guard shardLock {shard.mMutex};
+      const auto count = ::std::min(shard.mRecorded, Capacity);
+      const auto oldest = (shard.mHead + Capacity - count) % Capacity;
+
+      // Name the thread, so that it can be told apart in the viewer    
+      auto length = ::std::snprintf(line, sizeof(line),
+         "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,"
+         "\"args\":{\"name\":\"AI thread %zu\"}}",
+         first ? "" : ",", static_cast<size_t>(shard.mThread),
+         static_cast<size_t>(shard.mThread));
+      ok = ok and file.Write(line, static_cast<Size>(length));
+      first = false;
+
+      // Spans are complete events, timed in microseconds               
+      for (Offset i = 0; i < count and ok; ++i) {
+         const auto& event = shard.mEvents[(oldest + i) % Capacity];
+         length = ::std::snprintf(line, sizeof(line),
+            ",\n{\"name\":\"%s\",\"cat\":\"ai\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,"
+            "\"ts\":%.3f,\"dur\":%.3f}",
+            event.mName, static_cast<size_t>(shard.mThread),
+            static_cast<double>(event.mStart) / 1000.0,
+            static_cast<double>(event.mDuration) / 1000.0);
+         ok = file.Write(line, static_cast<Size>(length));
+      }
+   }
+
+   ok = ok and file.Write(Footer, sizeof(Footer) - 1);
+   if (not ok)
+      Logger::Error("Can't write traces to `", path, '`');
+   return ok;
+}
+
+/// Forget all recorded spans                                                 
+void Trace::Reset() {
+   auto& registry = GetRegistry();
+   const ::std::lock_guard lock {registry.mMutex};
+   for (auto& shard : registry.mShards) {
+      const ::std::lock_guard shardLock {shard.mMutex};
+      shard.mHead = 0;
+      shard.mRecorded = 0;
+   }
+}
+
+#else
+
+/// Tracing is compiled out, so there's nothing to dump                       
+///   @param path - the file that would've been written                       
+///   @return false                                                           
+bool Trace::Dump(const Text& path) {
+   Logger::Error("Can't dump traces to `", path,
+      "` - the module was built without LANGULUS_MOD_AI_TRACE");
+   return false;
+}
+
+/// Tracing is compiled out, so there's nothing to forget                     
+void Trace::Reset() {}
+
+#endif
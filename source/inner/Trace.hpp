@@ -0,0 +1,48 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <cstdint>
+
+
+///                                                                           
+///   Span tracing of the AI module                                           
+///                                                                           
+/// Spans are timed scopes, recorded into a ring buffer of the thread they    
+/// ran on, so only the most recent ones are kept. They can be dumped in the  
+/// Chrome trace event format, and loaded in chrome://tracing or Perfetto.    
+/// Tracing is compiled out entirely, unless the module is built with         
+/// LANGULUS_MOD_AI_TRACE                                                     
+///                                                                           
+struct Trace {
+   // Number of most recent spans kept for each thread                  
+   static constexpr Count Capacity = 64 * 1024;
+
+   static bool Dump(const Text&);
+   static void Reset();
+
+#if LANGULUS_MOD_AI_TRACE
+   /// Records the scope it lives in as a span                                
+   struct Span {
+   private:
+      const char* mName;
+      ::std::uint64_t mStart;
+
+   public:
+      Span(const char*) noexcept;
+      Span(const Span&) = delete;
+      ~Span();
+   };
+#endif
+};
+
+#if LANGULUS_MOD_AI_TRACE
+   #define AI_TRACE(name)     const Trace::Span span {name}
+#else
+   #define AI_TRACE(name)     LANGULUS(NOOP)
+#endif
@@ -0,0 +1,194 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "Workers.hpp"
+#include <algorithm>
+
+
+/// Join all threads                                                          
+Workers::~Workers() {
+   Stop();
+}
+
+/// Change the number of threads, including the calling one                   
+///   @param count - number of threads; zero or one runs everything on the    
+///                  calling thread                                           
+void Workers::SetThreadCount(Count count) {
+   count = ::std::max<Count>(count, 1);
+   if (count == GetThreadCount())
+      return;
+
+   Stop();
+   mStopping = false;
+   for (Offset i = 0; i < count; ++i)
+      mQueues.emplace_back(::std::make_unique<Queue>());
+   for (Offset i = 1; i < count; ++i)
+      mThreads.emplace_back([this, i] { Loop(i); });
+}
+
+/// Get the number of threads, including the calling one                      
+///   @return the number of threads                                           
+auto Workers::GetThreadCount() const noexcept -> Count {
+   return ::std::max<Count>(mQueues.size(), 1);
+}
+
+/// Stop and join all additional threads                                      
+void Workers::Stop() {
+   {
+      const ::std::lock_guard lock {mMutex};
+      mStopping = true;
+   }
+   mWake.notify_all();
+   for (auto& thread : mThreads)
+      thread.join();
+   mThreads.clear();
+   mQueues.clear();
+}
+
+/// Take a batch from a worker's own queue, or steal one from another         
+///   @param worker - the worker's index                                      
+///   @param batch - [out] the batch to execute                               
+///   @return true if a batch was taken                                       
+bool Workers::Pop(Offset worker, Batch& batch) {
+   {
+      auto& own = *mQueues[worker];
+      const ::std::lock_guard lock {own.mMutex};
+      if (not own.mBatches.empty()) {
+         batch = own.mBatches.front();
+         own.mBatches.pop_front();
+         return true;
+      }
+   }
+
+   for (Offset i = 1; i < mQueues.size(); ++i) {
+      auto& victim = *mQueues[(worker + i) % mQueues.size()];
+      const ::std::lock_guard lock {victim.mMutex};
+      if (not victim.mBatches.empty()) {
+         batch = victim.mBatches.back();
+         victim.mBatches.pop_back();
+         return true;
+      }
+   }
+   return false;
+}
+
+/// Execute batches until there are none left                                 
+///   @param worker - the worker's index                                      
+void Workers::Work(Offset worker) {
+   Batch batch;
+   while (Pop(worker, batch)) {
+      for (auto i = batch.mBegin; i < batch.mEnd; ++i)
+         mJob(i);
+
+      if (mPending.fetch_sub(1) == 1) {
+         const ::std::lock_guard lock {mMutex};
+         mDone.notify_all();
+      }
+   }
+}
+
+/// Thread loop of additional workers                                         
+///   @param worker - the worker's index                                      
+void Workers::Loop(Offset worker) {
+   Count seen = 0;
+   while (true) {
+      {
+         ::std::unique_lock lock {mMutex};
+         mWake.wait(lock, [&] { return mStopping or mGeneration != seen; });
+         if (mStopping)
+            return;
+         seen = mGeneration;
+      }
+      Work(worker);
+   }
+}
+
+/// Run a function over a range of indices, and wait for it to complete       
+///   @param count - number of indices                                        
+///   @param batch - number of consecutive indices executed together          
+///   @param job - the function to call with each index                       
+void Workers::ForEach(
+   Count count, Count batch, const ::std::function<void(Offset)>& job
+) {
+   batch = ::std::max<Count>(batch, 1);
+   if (mThreads.empty() or count <= batch) {
+      // Single-threaded fallback                                       
+      for (Offset i = 0; i < count; ++i)
+         job(i);
+      return;
+   }
+
+   // Deal the batches round-robin. Workers still finishing the         
+   // previous job may already start taking them, so the job and the    
+   // counter have to be ready before the first batch is dealt          
+   mJob = job;
+   mPending = (count + batch - 1) / batch;
+   for (Offset begin = 0, index = 0; begin < count; begin += batch, ++index) {
+      auto& queue = *mQueues[index % mQueues.size()];
+      const ::std::lock_guard lock {queue.mMutex};
+      queue.mBatches.push_back({begin, ::std::min(begin + batch, count)});
+   }
+
+   {
+      const ::std::lock_guard lock {mMutex};
+      ++mGeneration;
+   }
+   mWake.notify_all();
+
+   // Participate, then wait for the stragglers                         
+   Work(0);
+   ::std::unique_lock lock {mMutex};
+   mDone.wait(lock, [&] { return mPending == 0; });
+   mJob = {};
+}
+
+
+/// Complete all submitted jobs and join the thread                           
+Background::~Background() {
+   Stop();
+}
+
+/// Execute a job on the background thread                                    
+///   @param job - the job to execute                                         
+void Background::Submit(::std::function<void()>&& job) {
+   {
+      const ::std::lock_guard lock {mMutex};
+      mJobs.emplace_back(::std::move(job));
+      if (not mThread.joinable()) {
+         mStopping = false;
+         mThread = ::std::thread {[this] { Loop(); }};
+      }
+   }
+   mWake.notify_one();
+}
+
+/// Complete all submitted jobs and join the thread                           
+void Background::Stop() {
+   {
+      const ::std::lock_guard lock {mMutex};
+      mStopping = true;
+   }
+   mWake.notify_one();
+   if (mThread.joinable())
+      mThread.join();
+}
+
+/// Thread loop of the background worker                                      
+void Background::Loop() {
+   while (true) {
+      ::std::function<void()> job;
+      {
+         ::std::unique_lock lock {mMutex};
+         mWake.wait(lock, [&] { return mStopping or not mJobs.empty(); });
+         if (mJobs.empty())
+            return;
+         job = ::std::move(mJobs.front());
+         mJobs.pop_front();
+      }
+      job();
+   }
+}
@@ -0,0 +1,97 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#pragma once
+#include "../Common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+///                                                                           
+///   Work-stealing thread pool                                               
+///                                                                           
+/// Runs a function over a range of indices, split into fixed-size batches.   
+/// Batches are dealt round-robin to the workers' queues, and workers that    
+/// run out of batches steal from the back of other queues. Batch boundaries  
+/// never depend on the number of threads, so as long as the function only    
+/// touches state owned by its index, results are identical to running the    
+/// whole range sequentially on a single thread - which is exactly what       
+/// happens when there are no additional threads.                             
+///                                                                           
+struct Workers {
+private:
+   struct Batch {
+      Offset mBegin;
+      Offset mEnd;
+   };
+
+   struct Queue {
+      ::std::mutex mMutex;
+      ::std::deque<Batch> mBatches;
+   };
+
+   // One queue per thread, the calling thread always uses the first    
+   ::std::vector<::std::unique_ptr<Queue>> mQueues;
+   ::std::vector<::std::thread> mThreads;
+
+   // Currently executed job                                            
+   ::std::function<void(Offset)> mJob;
+   ::std::atomic<Count> mPending = 0;
+
+   ::std::mutex mMutex;
+   ::std::condition_variable mWake;
+   ::std::condition_variable mDone;
+   Count mGeneration = 0;
+   bool mStopping = false;
+
+   bool Pop(Offset, Batch&);
+   void Work(Offset);
+   void Loop(Offset);
+   void Stop();
+
+public:
+   Workers() = default;
+   Workers(const Workers&) = delete;
+   ~Workers();
+
+   void SetThreadCount(Count);
+   auto GetThreadCount() const noexcept -> Count;
+
+   void ForEach(Count, Count, const ::std::function<void(Offset)>&);
+};
+
+
+///                                                                           
+///   Background worker                                                       
+///                                                                           
+/// Executes jobs in order of submission, on a single thread that is started  
+/// on demand. Stopping it completes all submitted jobs first.                
+///                                                                           
+struct Background {
+private:
+   ::std::thread mThread;
+   ::std::mutex mMutex;
+   ::std::condition_variable mWake;
+   ::std::deque<::std::function<void()>> mJobs;
+   bool mStopping = false;
+
+   void Loop();
+
+public:
+   Background() = default;
+   Background(const Background&) = delete;
+   ~Background();
+
+   void Submit(::std::function<void()>&&);
+   void Stop();
+};
@@ -0,0 +1,273 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/Ontology.hpp"
+#include <Langulus/Testing.hpp>
+#include <future>
+#include <thread>
+
+
+/// Check if an interpretation mentions an idea anywhere                      
+///   @param interpretation - the interpretation                              
+///   @param idea - the idea to look for                                      
+///   @return true if the idea is mentioned                                   
+static bool Mentions(const Many& interpretation, const Idea* idea) {
+   bool found = false;
+   interpretation.ForEachDeep([&](Idea* mentioned) {
+      if (mentioned == idea)
+         found = true;
+   });
+   return found;
+}
+
+SCENARIO("Cached interpretations across epochs", "[ai][epochs]") {
+   GIVEN("An ontology that interprets a text, and then learns a word in it") {
+      Ontology ontology;
+      {
+         const auto writer = ontology.Write();
+         ontology.Build(Many {Text {"one"}});
+      }
+
+      Idea* two = nullptr;
+      const auto learn = [&] {
+         REQUIRE_FALSE(ontology.Interpret(Text {"onetwo"}).IsEmpty());
+         two = ontology.Build(Many {Text {"two"}});
+      };
+
+      WHEN("The writer's thread interprets the text again, before publishing") {
+         Many interpretation;
+         {
+            const auto writer = ontology.Write();
+            learn();
+            interpretation = ontology.Interpret(Text {"onetwo"});
+         }
+
+         THEN("The new word is part of the interpretation") {
+            REQUIRE(Mentions(interpretation, two));
+         }
+      }
+
+      WHEN("A reader interprets the text from a view, after publishing") {
+         {
+            const auto writer = ontology.Write();
+            learn();
+         }
+
+         const auto interpretation = ::std::async(::std::launch::async, [&] {
+            const auto view = ontology.Read();
+            return ontology.Interpret(Text {"onetwo"});
+         }).get();
+
+         THEN("The new word is part of the interpretation") {
+            REQUIRE(Mentions(interpretation, two));
+         }
+      }
+
+      WHEN("The writer's thread keeps learning after interpreting") {
+         Epoch interpreted, learned, continued;
+         {
+            const auto writer = ontology.Write();
+            ontology.Interpret(Text {"onetwo"});
+            interpreted = ontology.GetEpoch();
+            ontology.Build(Many {Text {"two"}});
+            learned = ontology.GetEpoch();
+            ontology.Build(Many {Text {"three"}});
+            continued = ontology.GetEpoch();
+         }
+
+         THEN("Only the first thing learned begins a new epoch") {
+            REQUIRE(learned > interpreted);
+            REQUIRE(continued == learned);
+         }
+      }
+
+      ontology.Teardown();
+   }
+}
+
+SCENARIO("Isolation of readers", "[ai][epochs]") {
+   GIVEN("A reader viewing an ontology, while the writer links ideas") {
+      Ontology ontology;
+      Idea* one = nullptr;
+      Idea* two = nullptr;
+      {
+         const auto writer = ontology.Write();
+         one = ontology.Build(Many {Text {"one"}});
+         two = ontology.Build(Many {Text {"two"}});
+      }
+
+      ::std::promise<void> viewing;
+      ::std::promise<void> learned;
+      auto reader = ::std::async(::std::launch::async, [&] {
+         const auto view = ontology.Read();
+         viewing.set_value();
+         learned.get_future().wait();
+         return one->HasAssociation(two);
+      });
+
+      viewing.get_future().wait();
+      {
+         const auto writer = ontology.Write();
+         one->Associate(two);
+      }
+      learned.set_value();
+
+      THEN("The reader doesn't see the link learned after its view began") {
+         REQUIRE_FALSE(reader.get());
+      }
+
+      THEN("A new reader sees it") {
+         const auto seen = ::std::async(::std::launch::async, [&] {
+            const auto view = ontology.Read();
+            return one->HasAssociation(two);
+         }).get();
+         REQUIRE(seen);
+         reader.get();
+      }
+
+      ontology.Teardown();
+   }
+}
+
+SCENARIO("Forgetting ideas that readers are viewing", "[ai][epochs]") {
+   GIVEN("A reader viewing an ontology, while the writer forgets an idea") {
+      Ontology ontology;
+      Idea* one = nullptr;
+      Idea* two = nullptr;
+      {
+         const auto writer = ontology.Write();
+         one = ontology.Build(Many {Text {"one"}});
+         two = ontology.Build(Many {Text {"two"}});
+         two->Associate(one);
+      }
+
+      ::std::promise<void> viewing;
+      ::std::promise<void> forgotten;
+      auto reader = ::std::async(::std::launch::async, [&] {
+         const auto view = ontology.Read();
+         viewing.set_value();
+         forgotten.get_future().wait();
+         return Mentions(ontology.Interpret(Text {"two"}), two)
+            and two->HasAssociation(one);
+      });
+
+      viewing.get_future().wait();
+      {
+         const auto writer = ontology.Write();
+         Verbs::Create forget {Construct::From<Idea>(Many {Text {"two"}})};
+         forget.SetMass(-1);
+         ontology.Create(forget);
+         REQUIRE(forget.IsDone());
+      }
+      {
+         const auto writer = ontology.Write();
+         ontology.Update();
+      }
+      forgotten.set_value();
+
+      THEN("The reader still sees the idea and its links, as they were") {
+         REQUIRE(reader.get());
+      }
+
+      THEN("Once the reader is done, the idea is learned anew") {
+         reader.get();
+         {
+            const auto writer = ontology.Write();
+            ontology.Update();
+         }
+
+         const auto writer = ontology.Write();
+         REQUIRE(ontology.GetIdeaCount() == 1);
+         auto again = ontology.Build(Many {Text {"two"}});
+         REQUIRE(ontology.GetIdeaCount() == 2);
+         REQUIRE_FALSE(again->HasAssociation(one));
+         REQUIRE_FALSE(one->HasAssociation(again));
+      }
+
+      THEN("Creating the idea through a verb revives it, instead of handing it back to be reclaimed") {
+         Idea* again;
+         {
+            const auto writer = ontology.Write();
+            Verbs::Create create {Construct::From<Idea>(Many {Text {"two"}})};
+            ontology.Create(create);
+            REQUIRE(create.IsDone());
+            again = create.GetOutput().template As<Idea*>();
+            REQUIRE(ontology.GetIdeaCount() == 2);
+         }
+
+         reader.get();
+         {
+            const auto writer = ontology.Write();
+            ontology.Update();
+         }
+
+         const auto writer = ontology.Write();
+         REQUIRE(ontology.GetIdeaCount() == 2);
+         REQUIRE(ontology.Build(Many {Text {"two"}}) == again);
+         REQUIRE_FALSE(again->HasAssociation(one));
+      }
+
+      ontology.Teardown();
+   }
+}
+
+SCENARIO("Reclaiming versions of links", "[ai][epochs]") {
+   GIVEN("Links with a version that a reader is viewing") {
+      Ontology ontology;
+      Idea* a;
+      Idea* b;
+      Idea* c;
+      {
+         const auto writer = ontology.Write();
+         a = ontology.Build(Many {Text {"a"}});
+         b = ontology.Build(Many {Text {"b"}});
+         c = ontology.Build(Many {Text {"c"}});
+      }
+
+      Links links;
+      REQUIRE(links.Append(a, 1, 0));
+      ::std::weak_ptr<const Links::Version> first;
+      {
+         const auto view = links.Read(1);
+         first = view.mVersion;
+      }
+
+      WHEN("Something is appended while the reader might still view it") {
+         REQUIRE(links.Append(b, 2, 0));
+
+         THEN("The old version is kept, and doesn't see the new link") {
+            REQUIRE_FALSE(first.expired());
+            const auto view = links.Read(1);
+            REQUIRE(view.Contains(a));
+            REQUIRE_FALSE(view.Contains(b));
+            REQUIRE(links.Read(2).Contains(b));
+         }
+      }
+
+      WHEN("Something is appended after all readers moved on") {
+         REQUIRE(links.Append(b, 2, 0));
+         REQUIRE(links.Append(c, 3, 2));
+
+         THEN("Versions nobody can view anymore are reclaimed") {
+            REQUIRE(first.expired());
+            REQUIRE(links.Latest().GetCount() == 3);
+         }
+      }
+
+      WHEN("Something is appended again in the same epoch") {
+         REQUIRE(links.Append(b, 1, 0));
+
+         THEN("The version is changed in place") {
+            REQUIRE_FALSE(first.expired());
+            REQUIRE(first.lock()->mIdeas.GetCount() == 2);
+         }
+      }
+
+      links.Reset();
+      ontology.Teardown();
+   }
+}
@@ -0,0 +1,587 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/History.hpp"
+#include <Langulus/Verbs/Associate.hpp>
+#include <Langulus/Verbs/Create.hpp>
+#include <Langulus/Verbs/Select.hpp>
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = ::std::filesystem;
+
+
+/// Make a point in time                                                      
+///   @param tick - milliseconds since the beginning                          
+///   @return the time                                                        
+static auto At(int tick) -> Time {
+   return Time {::std::chrono::milliseconds {tick}};
+}
+
+/// Make the n-th event of a test - verb types and arguments repeat, and      
+/// every two events happen at the same time                                  
+///   @param n - the event number                                             
+///   @return the verb                                                        
+static auto MakeEvent(Offset n) -> Verb {
+   const auto word = "w" + ::std::to_string(n % 5);
+   const Many argument {Text {word.c_str()}};
+   switch (n % 3) {
+   case 0:  return Verbs::Create {argument};
+   case 1:  return Verbs::Select {argument};
+   default: return Verbs::Associate {argument};
+   }
+}
+
+/// The verb types the test events are made of                                
+static const VMeta Types[] {
+   MetaVerbOf<Verbs::Create>(),
+   MetaVerbOf<Verbs::Select>(),
+   MetaVerbOf<Verbs::Associate>()
+};
+
+/// An event, as remembered by the reference                                  
+struct Event {
+   Time mTime;
+   Verb mVerb;
+};
+
+/// Naive reference of a history - it remembers every event ever pushed, and  
+/// nothing else, so a history must agree with it on whatever it still keeps  
+struct Reference {
+   ::std::vector<Event> mEvents;
+
+   /// Push the n-th test event into both the reference and a history         
+   ///   @param history - the history                                         
+   ///   @param n - the event number                                          
+   void Push(History& history, Offset n) {
+      mEvents.push_back({At(static_cast<int>(n / 2)), MakeEvent(n)});
+      history.Push(mEvents.back().mTime, mEvents.back().mVerb);
+   }
+
+   /// Count the events of a type                                             
+   ///   @param type - the verb type                                          
+   ///   @return the number of events of that type                            
+   auto CountOf(VMeta type) const -> Count {
+      return static_cast<Count>(::std::count_if(mEvents.begin(), mEvents.end(),
+         [&](const Event& event) { return event.mVerb.GetVerb() == type; }));
+   }
+
+   /// Check that a history agrees with the reference: its recent events are  
+   /// the newest ones verbatim, its summaries account for all the older      
+   /// ones in order, and it counts every verb type exactly                   
+   ///   @param history - the history                                         
+   void Check(const History& history) const {
+      const auto& budget = history.GetBudget();
+      const auto recent = history.GetCount();
+      REQUIRE(recent <= mEvents.size());
+      const auto compacted = mEvents.size() - recent;
+      REQUIRE(history.GetNext() == mEvents.size());
+
+      for (Offset i = 0; i < recent; ++i) {
+         const auto& event = mEvents[compacted + i];
+         REQUIRE(history.GetTime(i) == event.mTime);
+         REQUIRE(history.GetType(i) == event.mVerb.GetVerb());
+         REQUIRE(history.GetVerb(i) == event.mVerb);
+      }
+
+      const auto& summaries = history.GetSummaries();
+      REQUIRE(summaries.size() <= budget.mSummaries);
+      Count summarized = 0;
+      for (auto& summary : summaries) {
+         REQUIRE(summary.mEvents > 0);
+         REQUIRE(summary.mFrom == mEvents[summarized].mTime);
+         summarized += summary.mEvents;
+         REQUIRE(summary.mTo == mEvents[summarized - 1].mTime);
+         REQUIRE(summary.mDistinct.GetCount() <= budget.mDistinct);
+      }
+      REQUIRE(summarized == compacted);
+
+      for (auto type : Types)
+         REQUIRE(history.CountOf(type) == CountOf(type));
+   }
+};
+
+/// Simulate the number of recent events after one more push - a full ring    
+/// compacts its oldest window first                                          
+///   @param recent - the number of recent events before the push             
+///   @param budget - the budget of the history                               
+///   @return the number of recent events after the push                      
+static auto AfterPush(Count recent, const History::Budget& budget) -> Count {
+   if (recent >= budget.mRecent)
+      recent -= ::std::min(budget.mWindow, recent);
+   return recent + 1;
+}
+
+/// The events a query visited, in order                                      
+using Visited = ::std::vector<Event>;
+
+/// Make a function that records the events a query visits                    
+///   @param visited - [out] where to record the events                       
+///   @return the function, to pass to ForEachIn, ForEachOf or ForEachAbout   
+static auto Visit(Visited& visited) {
+   return [&visited](Time time, const Verb& verb) {
+      visited.push_back({time, verb});
+   };
+}
+
+/// Check that every range query of a history agrees with a naive scan of     
+/// the reference, in a time range [from; to]                                 
+///   @param reference - the reference                                        
+///   @param history - the history                                            
+///   @param from - the earliest time, inclusive                              
+///   @param to - the latest time, inclusive                                  
+static void CheckQueries(const Reference& reference, const History& history, Time from, Time to) {
+   const auto compacted = reference.mEvents.size() - history.GetCount();
+   const auto inRange = [&](const Event& event) {
+      return not (event.mTime < from) and not (to < event.mTime);
+   };
+   const auto same = [](const Visited& visited, const ::std::vector<const Event*>& expected) {
+      REQUIRE(visited.size() == expected.size());
+      for (Offset i = 0; i < visited.size(); ++i) {
+         REQUIRE(visited[i].mTime == expected[i]->mTime);
+         REQUIRE(visited[i].mVerb == expected[i]->mVerb);
+      }
+   };
+
+   // The recent events in range are consecutive, because times only grow
+   ::std::vector<const Event*> expected;
+   Offset begin = history.GetCount(), end = 0;
+   for (Offset i = 0; i < history.GetCount(); ++i) {
+      const auto& event = reference.mEvents[compacted + i];
+      if (not inRange(event))
+         continue;
+      expected.push_back(&event);
+      begin = ::std::min(begin, i);
+      end = i + 1;
+   }
+
+   const auto range = history.Range(from, to);
+   if (expected.empty())
+      REQUIRE(range.first == range.second);
+   else {
+      REQUIRE(range.first == begin);
+      REQUIRE(range.second == end);
+   }
+
+   Visited visited;
+   history.ForEachIn(from, to, Visit(visited));
+   same(visited, expected);
+
+   for (auto type : Types) {
+      ::std::vector<const Event*> ofType;
+      for (auto event : expected) {
+         if (event->mVerb.GetVerb() == type)
+            ofType.push_back(event);
+      }
+
+      visited.clear();
+      history.ForEachOf(type, from, to, Visit(visited));
+      same(visited, ofType);
+
+      // Summaries are counted only when they lie entirely in the range 
+      Count count = ofType.size();
+      Offset summarized = 0;
+      for (auto& summary : history.GetSummaries()) {
+         const auto first = summarized;
+         summarized += summary.mEvents;
+         if (summary.mFrom < from or to < summary.mTo)
+            continue;
+
+         for (auto i = first; i < summarized; ++i) {
+            if (reference.mEvents[i].mVerb.GetVerb() == type)
+               ++count;
+         }
+      }
+      REQUIRE(history.CountOf(type, from, to) == count);
+   }
+
+   for (auto word : {"w0", "w3", "nothing"}) {
+      const Many argument {Text {word}};
+      ::std::vector<const Event*> about;
+      for (auto event : expected) {
+         if (event->mVerb.GetArgument() == argument)
+            about.push_back(event);
+      }
+
+      visited.clear();
+      history.ForEachAbout(argument, from, to, Visit(visited));
+      same(visited, about);
+   }
+}
+
+/// Check the range queries of a history over every time range around its     
+/// events - including ranges that begin or end on equal timestamps, empty    
+/// and reversed ranges, and ranges outside of everything                     
+///   @param reference - the reference                                        
+///   @param history - the history                                            
+static void CheckAllQueries(const Reference& reference, const History& history) {
+   const auto last = static_cast<int>((reference.mEvents.size() - 1) / 2);
+   for (int from = -1; from <= last + 1; ++from) {
+      for (int to = from - 1; to <= last + 1; ++to)
+         CheckQueries(reference, history, At(from), At(to));
+   }
+}
+
+SCENARIO("Bounded history", "[ai][history]") {
+   GIVEN("A history with a small budget") {
+      History::Budget budget;
+      budget.mRecent = 8;
+      budget.mWindow = 3;
+      budget.mSummaries = 4;
+      budget.mDistinct = 2;
+
+      History history {budget};
+      Reference reference;
+
+      WHEN("Many more events are pushed than the ring buffer holds") {
+         Count recent = 0;
+         for (Offset n = 0; n < 100; ++n) {
+            reference.Push(history, n);
+            recent = AfterPush(recent, budget);
+            REQUIRE(history.GetCount() == recent);
+            reference.Check(history);
+         }
+
+         THEN("The ring wraps around, and the oldest summaries are merged to stay in budget") {
+            const auto& summaries = history.GetSummaries();
+            REQUIRE(summaries.size() == budget.mSummaries);
+            REQUIRE(summaries.front().mEvents > budget.mWindow);
+            for (Offset i = 1; i < summaries.size(); ++i)
+               REQUIRE(summaries[i].mEvents == budget.mWindow);
+         }
+      }
+
+      WHEN("The ring buffer overflows for the first time") {
+         for (Offset n = 0; n <= budget.mRecent; ++n)
+            reference.Push(history, n);
+
+         THEN("Exactly the oldest window is compacted into a summary") {
+            reference.Check(history);
+            REQUIRE(history.GetCount() == budget.mRecent - budget.mWindow + 1);
+
+            const auto& summaries = history.GetSummaries();
+            REQUIRE(summaries.size() == 1);
+            auto& summary = summaries.front();
+            REQUIRE(summary.mEvents == budget.mWindow);
+            for (auto type : Types)
+               REQUIRE(summary.mCounts.FindIt(type).GetValue() == 1);
+            REQUIRE(summary.mDistinct.GetCount() == budget.mDistinct);
+            REQUIRE(summary.Contains(MakeEvent(0)));
+            REQUIRE(summary.Contains(MakeEvent(1)));
+            REQUIRE_FALSE(summary.Contains(MakeEvent(2)));
+         }
+      }
+
+      WHEN("Events are pinned, and many more are pushed") {
+         for (Offset n = 0; n < 5; ++n)
+            reference.Push(history, n);
+         const auto pinned = history.GetNext();
+         history.Pin(pinned);
+
+         const Count pushed = budget.mRecent * 4;
+         for (Offset n = 5; n < 5 + pushed; ++n) {
+            reference.Push(history, n);
+            reference.Check(history);
+         }
+
+         THEN("Only the events before the pin are compacted, and the ring grows to keep the rest") {
+            REQUIRE(history.GetCount() == pushed);
+            REQUIRE(history.GetNext() - history.GetCount() == pinned);
+            Count summarized = 0;
+            for (auto& summary : history.GetSummaries())
+               summarized += summary.mEvents;
+            REQUIRE(summarized == 5);
+         }
+
+         THEN("Pinning a later event releases the earlier ones on the next push") {
+            history.Pin(history.GetNext());
+            reference.Push(history, 5 + pushed);
+            reference.Check(history);
+            REQUIRE(history.GetCount() == pushed - budget.mWindow + 1);
+         }
+      }
+
+      WHEN("The budget changes after the ring buffer has wrapped around") {
+         for (Offset n = 0; n < 21; ++n)
+            reference.Push(history, n);
+         reference.Check(history);
+         const auto before = history.GetCount();
+
+         THEN("Shrinking it compacts the events that no longer fit, in order") {
+            auto smaller = budget;
+            smaller.mRecent = 4;
+            smaller.mWindow = 2;
+            history.SetBudget(smaller);
+
+            Count recent = 0;
+            for (Offset i = 0; i < before; ++i)
+               recent = AfterPush(recent, smaller);
+            REQUIRE(history.GetCount() == recent);
+            reference.Check(history);
+
+            reference.Push(history, 21);
+            reference.Check(history);
+         }
+
+         THEN("Growing it keeps every recent event, in order") {
+            auto larger = budget;
+            larger.mRecent = 32;
+            history.SetBudget(larger);
+            REQUIRE(history.GetCount() == before);
+            reference.Check(history);
+
+            for (Offset n = 21; n < 40; ++n)
+               reference.Push(history, n);
+            REQUIRE(history.GetCount() == before + 19);
+            reference.Check(history);
+         }
+      }
+   }
+}
+
+SCENARIO("History range queries", "[ai][history]") {
+   GIVEN("A history with a small budget") {
+      History::Budget budget;
+      budget.mRecent = 8;
+      budget.mWindow = 3;
+      budget.mSummaries = 4;
+
+      History history {budget};
+      Reference reference;
+
+      WHEN("Nothing has been pushed yet") {
+         THEN("Every query is empty") {
+            const auto range = history.Range(At(0), At(10));
+            REQUIRE(range.first == range.second);
+            for (auto type : Types)
+               REQUIRE(history.CountOf(type, At(0), At(10)) == 0);
+
+            Visited visited;
+            history.ForEachIn(At(0), At(10), Visit(visited));
+            history.ForEachOf(Types[0], At(0), At(10), Visit(visited));
+            history.ForEachAbout(Many {Text {"w0"}}, At(0), At(10), Visit(visited));
+            REQUIRE(visited.empty());
+         }
+      }
+
+      WHEN("Fewer events are pushed than the ring buffer holds") {
+         for (Offset n = 0; n < 7; ++n)
+            reference.Push(history, n);
+
+         THEN("Every query agrees with a naive scan") {
+            REQUIRE(history.GetSummaries().empty());
+            CheckAllQueries(reference, history);
+         }
+      }
+
+      WHEN("Enough events are pushed to wrap the ring buffer, and compact many windows") {
+         for (Offset n = 0; n < 31; ++n)
+            reference.Push(history, n);
+
+         THEN("Every query agrees with a naive scan, over the recent events and the summaries") {
+            REQUIRE(history.GetNext() - history.GetCount() > budget.mRecent);
+            CheckAllQueries(reference, history);
+         }
+      }
+   }
+}
+
+/// Get an empty folder in the temporary folder, removing anything left       
+/// there by a previous run                                                   
+///   @param name - name of the folder                                        
+///   @return the path                                                        
+static auto ScratchFolder(const char* name) -> fs::path {
+   const auto folder = fs::temp_directory_path() / "LangulusModAITest" / name;
+   fs::remove_all(folder);
+   fs::create_directories(folder);
+   return folder;
+}
+
+/// Stream events from a history                                              
+///   @param stream - the stream to drain                                     
+///   @return the streamed events, in order                                   
+static auto Drain(History::Stream&& stream) -> Visited {
+   Visited streamed;
+   while (stream.Next())
+      streamed.push_back({stream.GetTime(), stream.GetVerb()});
+   return streamed;
+}
+
+/// Check that streamed events are exactly the expected ones, in order        
+///   @param streamed - the streamed events                                   
+///   @param expected - the expected events                                   
+static void Same(const Visited& streamed, const Visited& expected) {
+   REQUIRE(streamed.size() == expected.size());
+   for (Offset i = 0; i < streamed.size(); ++i) {
+      REQUIRE(streamed[i].mTime == expected[i].mTime);
+      REQUIRE(streamed[i].mVerb == expected[i].mVerb);
+   }
+}
+
+/// Write a segment file by hand, with a record for each of the payloads      
+///   @param path - the file to write                                         
+///   @param first - sequence number of the first record                      
+///   @param time - time of all the records                                   
+///   @param payloads - the payloads                                          
+static void WriteSegment(const fs::path& path, History::Sequence first, Time time, const ::std::vector<Bytes>& payloads) {
+   HistorySegmentHeader header {};
+   ::std::memcpy(header.mMagic, HistorySegmentHeader::Magic, sizeof(header.mMagic));
+   header.mVersion = HistorySegmentHeader::CurrentVersion;
+   header.mEndianness = HistorySegmentHeader::NativeEndianness;
+   header.mFirst = first;
+   header.mCount = payloads.size();
+   ::std::memcpy(header.mFrom, &time, sizeof(Time));
+   ::std::memcpy(header.mTo, &time, sizeof(Time));
+
+   ByteWriter image;
+   image.WritePOD(header);
+   static constexpr ::std::uint8_t Padding[8] {};
+   for (auto& payload : payloads) {
+      HistoryRecord record {};
+      record.mPayload = payload.GetCount();
+      ::std::memcpy(record.mTime, &time, sizeof(Time));
+      image.WritePOD(record);
+      image.Write(payload.GetRaw(), payload.GetCount());
+      image.Write(Padding, AlignSection(payload.GetCount()) - payload.GetCount());
+   }
+
+   ::std::ofstream file {path, ::std::ios::binary};
+   file.write(reinterpret_cast<const char*>(image.GetRaw()),
+      static_cast<::std::streamsize>(image.GetWritten()));
+}
+
+SCENARIO("Spilled history", "[ai][history]") {
+   GIVEN("A history that spills compacted windows to disk") {
+      const auto folder = ScratchFolder("history");
+      const Text path {folder.string().c_str()};
+
+      History::Budget budget;
+      budget.mRecent = 8;
+      budget.mWindow = 3;
+      budget.mSummaries = 2;
+
+      History history {budget};
+      REQUIRE(history.Spill(path));
+
+      Reference reference;
+      for (Offset n = 0; n < 40; ++n)
+         reference.Push(history, n);
+      reference.Check(history);
+      const auto compacted = history.GetNext() - history.GetCount();
+
+      WHEN("Everything is replayed") {
+         const auto streamed = Drain(history.Replay());
+
+         THEN("Every event ever pushed is streamed back in order, although the summaries keep no samples") {
+            Same(streamed, reference.mEvents);
+            for (auto& summary : history.GetSummaries())
+               REQUIRE(summary.mDistinct.IsEmpty());
+
+            const auto& segments = history.GetSegments();
+            REQUIRE_FALSE(segments.empty());
+            History::Sequence next = 0;
+            for (auto& segment : segments) {
+               REQUIRE(segment.mFirst == next);
+               REQUIRE(segment.mEvents == budget.mWindow);
+               REQUIRE(segment.mFrom == reference.mEvents[next].mTime);
+               next += segment.mEvents;
+               REQUIRE(segment.mTo == reference.mEvents[next - 1].mTime);
+               REQUIRE(fs::exists(MappedFile::Path(segment.mPath)));
+            }
+            REQUIRE(next == compacted);
+         }
+      }
+
+      WHEN("Parts of it are replayed") {
+         THEN("Only the events in the time range, of the verb type, are streamed, from disk and memory alike") {
+            const auto last = static_cast<int>((reference.mEvents.size() - 1) / 2);
+            for (int from = -1; from <= last + 1; from += 3) {
+               for (int to = from - 1; to <= last + 1; to += 2) {
+                  for (auto type : {VMeta {}, Types[0], Types[1], Types[2]}) {
+                     Visited expected;
+                     for (auto& event : reference.mEvents) {
+                        if (event.mTime < At(from) or At(to) < event.mTime)
+                           continue;
+                        if (type and event.mVerb.GetVerb() != type)
+                           continue;
+                        expected.push_back(event);
+                     }
+
+                     Same(Drain(history.Replay(At(from), At(to), type)), expected);
+                  }
+               }
+            }
+         }
+      }
+
+      WHEN("A new history spills into the same folder") {
+         history.Replay();
+         History continued {budget};
+         REQUIRE(continued.Spill(path));
+
+         THEN("It rediscovers the segments, and continues their sequence") {
+            const auto& found = continued.GetSegments();
+            const auto& spilled = history.GetSegments();
+            REQUIRE(found.size() == spilled.size());
+            for (Offset i = 0; i < found.size(); ++i) {
+               REQUIRE(found[i].mFirst == spilled[i].mFirst);
+               REQUIRE(found[i].mEvents == spilled[i].mEvents);
+               REQUIRE(found[i].mFrom == spilled[i].mFrom);
+               REQUIRE(found[i].mTo == spilled[i].mTo);
+            }
+
+            REQUIRE(continued.GetCount() == 0);
+            REQUIRE(continued.GetNext() == compacted);
+            Same(Drain(continued.Replay()), Visited(
+               reference.mEvents.begin(), reference.mEvents.begin() + compacted
+            ));
+         }
+
+         THEN("A segment with a record that isn't a verb is cut short there") {
+            const auto time = At(100);
+            WriteSegment(folder / "99999999999999999999.hseg", compacted, time, {
+               EncodeDescriptor(Many {MakeEvent(0)}),
+               EncodeDescriptor(Many {Text {"not a verb"}}),
+               EncodeDescriptor(Many {MakeEvent(1)})
+            });
+
+            History corrupt {budget};
+            REQUIRE(corrupt.Spill(path));
+            REQUIRE(corrupt.GetSegments().size() == history.GetSegments().size() + 1);
+
+            auto expected = Visited(
+               reference.mEvents.begin(), reference.mEvents.begin() + compacted
+            );
+            expected.push_back({time, MakeEvent(0)});
+            Same(Drain(corrupt.Replay()), expected);
+         }
+      }
+
+      WHEN("The history is reset, after its ring buffer has grown") {
+         history.Pin(history.GetNext());
+         for (Offset n = 40; n < 60; ++n)
+            reference.Push(history, n);
+         history.Reset();
+
+         Reference again;
+         for (Offset n = 0; n < 20; ++n)
+            again.Push(history, n);
+
+         THEN("It forgets everything, including its segments, and starts over") {
+            again.Check(history);
+            REQUIRE(history.GetSegments().empty());
+            CheckAllQueries(again, history);
+         }
+      }
+   }
+}
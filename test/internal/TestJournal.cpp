@@ -0,0 +1,287 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/Ontology.hpp"
+#include <Langulus/Testing.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = ::std::filesystem;
+
+
+/// Get a path in the temporary folder, removing anything left there by a     
+/// previous run                                                              
+///   @param name - name of the file                                          
+///   @return the path                                                        
+static auto Scratch(const char* name) -> fs::path {
+   const auto folder = fs::temp_directory_path() / "LangulusModAITest";
+   fs::create_directories(folder);
+   const auto path = folder / name;
+   for (auto suffix : {"", ".old", ".tmp", ".keep"})
+      fs::remove(path.string() + suffix);
+   return path;
+}
+
+/// Convert a path to text                                                    
+///   @param path - the path                                                  
+///   @return the text                                                        
+static auto ToText(const fs::path& path) -> Text {
+   return Text {path.string().c_str()};
+}
+
+/// Get the hashes of all ideas, in order of their indices                    
+///   @param ontology - the ontology                                          
+///   @return the hashes                                                      
+static auto Hashes(const Ontology& ontology) -> ::std::vector<::std::uint64_t> {
+   ::std::vector<::std::uint64_t> hashes;
+   for (Offset i = 0; i < ontology.GetIdeaCount(); ++i)
+      hashes.push_back(ontology.GetIdeaHash(i));
+   return hashes;
+}
+
+SCENARIO("Ontology journals", "[ai][journal]") {
+   GIVEN("A persistent ontology that learned and forgot some ideas") {
+      const auto base = Scratch("journal.base");
+      const auto journal = Scratch("journal.log");
+      const auto folded = fs::path {journal.string() + ".old"};
+      ::std::vector<::std::uint64_t> learned;
+
+      {
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+         {
+            const auto writer = ontology.Write();
+            auto one   = ontology.Build(Many {Text {"one"}});
+            auto two   = ontology.Build(Many {Text {"two"}});
+            auto three = ontology.Build(Many {Text {"three"}});
+            auto four  = ontology.Build(Many {Text {"four"}});
+            one->Associate(two);
+            two->Associate(three);
+            three->Disassociate(four);
+            four->Associate(one);
+
+            Verbs::Create forget {Construct::From<Idea>(Many {Text {"two"}})};
+            forget.SetMass(-1);
+            ontology.Create(forget);
+            REQUIRE(forget.IsDone());
+         }
+
+         learned = Hashes(ontology);
+         ontology.Teardown();
+      }
+
+      // Checks that a recovered ontology is exactly the one above      
+      const auto recovered = [&](Ontology& ontology) {
+         REQUIRE(Hashes(ontology) == learned);
+
+         const auto writer = ontology.Write();
+         auto one   = ontology.Build(Many {Text {"one"}});
+         auto three = ontology.Build(Many {Text {"three"}});
+         auto four  = ontology.Build(Many {Text {"four"}});
+         REQUIRE(ontology.GetIdeaCount() == learned.size());
+         REQUIRE(three->HasDisassociation(four));
+         REQUIRE(four->HasAssociation(one));
+         REQUIRE(one->GetAssociations().GetCount() == 1);
+         REQUIRE(three->GetAssociations().GetCount() == 0);
+
+         // The forgotten idea is really gone                           
+         auto two = ontology.Build(Many {Text {"two"}});
+         REQUIRE(ontology.GetIdeaCount() == learned.size() + 1);
+         REQUIRE(two->GetAssociations().GetCount() == 0);
+      };
+
+      WHEN("The ontology is persisted again") {
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("Everything is replayed from the journal") {
+            recovered(ontology);
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("The ontology is persisted again, after it was compacted") {
+         {
+            Ontology ontology;
+            REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+            ontology.Teardown();
+         }
+
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("Everything is loaded from the base image") {
+            recovered(ontology);
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("The process crashed while writing the last record") {
+         {
+            ::std::ofstream file {journal, ::std::ios::binary | ::std::ios::app};
+            const char torn[20] = {1, 0, 0, 0, 100};
+            file.write(torn, sizeof(torn));
+         }
+
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("All complete records are replayed") {
+            recovered(ontology);
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("The process stopped while the journal was being folded") {
+         fs::rename(journal, folded);
+
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("The journal that was set aside is replayed and removed") {
+            recovered(ontology);
+            REQUIRE_FALSE(fs::exists(folded));
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("The process stopped after the journal was folded, but before it was removed") {
+         fs::copy_file(journal, journal.string() + ".keep");
+         {
+            Ontology ontology;
+            REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+            ontology.Teardown();
+         }
+         fs::rename(journal.string() + ".keep", folded);
+
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("The journal isn't replayed twice") {
+            recovered(ontology);
+            REQUIRE_FALSE(fs::exists(folded));
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("The journal is damaged") {
+         const auto size = fs::file_size(journal);
+         {
+            ::std::fstream file {journal, ::std::ios::binary | ::std::ios::in | ::std::ios::out};
+            file.write("GARBAGE!", 8);
+         }
+
+         Ontology ontology;
+
+         THEN("The ontology isn't persisted, and the journal is kept") {
+            REQUIRE_FALSE(ontology.Persist(ToText(base), ToText(journal)));
+            REQUIRE(fs::file_size(journal) == size);
+         }
+
+         ontology.Teardown();
+      }
+   }
+
+   GIVEN("A persistent ontology that learned ideas made of other ideas") {
+      const auto base = Scratch("composite.base");
+      const auto journal = Scratch("composite.log");
+      ::std::vector<::std::uint64_t> learned;
+
+      Many sequence;
+      sequence << Many {Text {"one"}} << Many {Text {"two"}};
+      Many alternatives;
+      alternatives << Many {Text {"two"}} << Many {Text {"three"}};
+      alternatives.MakeOr();
+
+      {
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+         {
+            const auto writer = ontology.Write();
+            ontology.Build(Many {Text {"zero"}});
+            auto pair = ontology.Build(sequence);
+            auto either = ontology.Build(alternatives);
+            pair->Associate(either);
+            pair->Associate(either);
+
+            // The last idea takes the place of the forgotten one, so   
+            // that it comes before the ideas it is made of             
+            Verbs::Create forget {Construct::From<Idea>(Many {Text {"zero"}})};
+            forget.SetMass(-1);
+            ontology.Create(forget);
+            REQUIRE(forget.IsDone());
+         }
+
+         // Stopped without compacting, so that all of it is replayed   
+         learned = Hashes(ontology);
+         ontology.Teardown();
+      }
+
+      WHEN("The ontology is persisted again") {
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("The ideas are made of the same parts, and linked the same way") {
+            REQUIRE(Hashes(ontology) == learned);
+
+            const auto writer = ontology.Write();
+            auto pair = ontology.Build(sequence);
+            auto either = ontology.Build(alternatives);
+            REQUIRE(ontology.GetIdeaCount() == learned.size());
+            REQUIRE(pair->HasAssociation(either));
+            REQUIRE(either->HasAssociation(pair));
+            REQUIRE(pair->GetAssociations().GetCount() == 1);
+         }
+
+         ontology.Teardown();
+      }
+
+      WHEN("An image is loaded into it, and it stops without compacting") {
+         Bytes image;
+         {
+            Ontology source;
+            {
+               const auto writer = source.Write();
+               auto five = source.Build(Many {Text {"five"}});
+               five->Associate(source.Build(Many {Text {"six"}}));
+            }
+            image = source.Save();
+            source.Teardown();
+         }
+
+         {
+            Ontology ontology;
+            REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+            {
+               const auto writer = ontology.Write();
+               REQUIRE(ontology.Load(image.GetRaw(), image.GetCount()));
+            }
+            ontology.Teardown();
+         }
+
+         Ontology ontology;
+         REQUIRE(ontology.Persist(ToText(base), ToText(journal)));
+
+         THEN("The loaded ideas are recovered with their links") {
+            const auto writer = ontology.Write();
+            auto five = ontology.Build(Many {Text {"five"}});
+            auto six = ontology.Build(Many {Text {"six"}});
+            REQUIRE(ontology.GetIdeaCount() == learned.size() + 2);
+            REQUIRE(five->HasAssociation(six));
+            REQUIRE(six->HasAssociation(five));
+         }
+
+         ontology.Teardown();
+      }
+   }
+}
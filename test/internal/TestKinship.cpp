@@ -0,0 +1,169 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/Kinship.hpp"
+#include "../../source/inner/Ontology.hpp"
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <optional>
+#include <string>
+
+
+/// Teach an ontology a range of numbered words                               
+///   @param ontology - the ontology to teach                                 
+///   @param prefix - the prefix of all words                                 
+///   @param from - the first number                                          
+///   @param to - the number after the last                                   
+static void Teach(Ontology& ontology, const char* prefix, Count from, Count to) {
+   const auto writer = ontology.Write();
+   for (Count i = from; i < to; ++i) {
+      const auto word = prefix + ::std::to_string(i);
+      ontology.Build(Many {Text {word.c_str()}});
+   }
+}
+
+/// Check if a group contains an ontology                                     
+///   @param group - the group                                                
+///   @param ontology - the ontology to look for                              
+///   @return true if the ontology is in the group                            
+static bool Contains(const Kinship::Group& group, const Ontology& ontology) {
+   return ::std::find(group.begin(), group.end(), &ontology) != group.end();
+}
+
+SCENARIO("Gathering kin ontologies", "[ai][kinship]") {
+   GIVEN("Two families of ontologies, and one that is unlike any other") {
+      Ontology a, b, c, x, y, loner;
+      for (auto member : {&a, &b, &c})
+         Teach(*member, "animal", 0, 100);
+      Teach(a, "pet", 0, 5);
+      Teach(b, "pet", 5, 10);
+      for (auto member : {&x, &y})
+         Teach(*member, "star", 0, 100);
+      Teach(loner, "rock", 0, 20);
+
+      Kinship kinship;
+      for (auto member : {&a, &b, &c, &x, &y, &loner})
+         kinship.Sign(*member);
+
+      WHEN("They are gathered") {
+         const auto groups = kinship.Gather(0.5, 2);
+
+         THEN("Each family is a group, and the loner is in none") {
+            REQUIRE(groups.size() == 2);
+            REQUIRE(groups[0].size() == 3);
+            REQUIRE(Contains(groups[0], a));
+            REQUIRE(Contains(groups[0], b));
+            REQUIRE(Contains(groups[0], c));
+            REQUIRE(groups[1].size() == 2);
+            REQUIRE(Contains(groups[1], x));
+            REQUIRE(Contains(groups[1], y));
+         }
+
+         THEN("Similarity is estimated from the signatures") {
+            REQUIRE(kinship.Similarity(a, c) > 0.8);
+            REQUIRE(kinship.Similarity(a, x) < 0.2);
+            REQUIRE(kinship.Similarity(c, c) == 1);
+         }
+      }
+
+      WHEN("Groups smaller than the minimum are gathered") {
+         const auto groups = kinship.Gather(0.5, 3);
+
+         THEN("They are left out") {
+            REQUIRE(groups.size() == 1);
+            REQUIRE(groups[0].size() == 3);
+         }
+      }
+
+      WHEN("A member is forgotten") {
+         kinship.Forget(x);
+
+         THEN("Its family is too small to be a group") {
+            const auto groups = kinship.Gather(0.5, 2);
+            REQUIRE(groups.size() == 1);
+            REQUIRE_FALSE(kinship.GetSignature(x));
+         }
+      }
+
+      WHEN("A member keeps learning its family's words") {
+         Teach(loner, "animal", 0, 100);
+         kinship.Sign(loner);
+
+         THEN("It joins that family") {
+            const auto groups = kinship.Gather(0.5, 2);
+            REQUIRE(groups.size() == 2);
+            REQUIRE(Contains(groups[0], loner));
+         }
+      }
+
+      for (auto member : {&a, &b, &c, &x, &y, &loner})
+         member->Teardown();
+   }
+
+   GIVEN("An ontology produced at the address of a destroyed one") {
+      ::std::optional<Ontology> reused;
+      reused.emplace();
+      Teach(*reused, "animal", 0, 100);
+
+      Kinship kinship;
+      kinship.Sign(*reused);
+      const auto address = &*reused;
+      reused->Teardown();
+      reused.reset();
+
+      reused.emplace();
+      REQUIRE(&*reused == address);
+      Teach(*reused, "star", 0, 200);
+      kinship.Sign(*reused);
+
+      THEN("It is signed from scratch, instead of inheriting the signature") {
+         Ontology fresh;
+         Teach(fresh, "star", 0, 200);
+         Kinship expected;
+         expected.Sign(fresh);
+         REQUIRE(*kinship.GetSignature(*reused) == *expected.GetSignature(fresh));
+         fresh.Teardown();
+      }
+
+      reused->Teardown();
+   }
+
+   GIVEN("An ontology that forgets ideas, and then learns more than it forgot") {
+      Ontology ontology;
+      Teach(ontology, "animal", 0, 100);
+
+      Kinship kinship;
+      kinship.Sign(ontology);
+      {
+         // Each forgotten idea is replaced by the last one, so indices 
+         // past the old count don't tell what was learned since        
+         const auto writer = ontology.Write();
+         for (Count i = 0; i < 10; ++i) {
+            const auto word = "animal" + ::std::to_string(i);
+            Verbs::Create forget {Construct::From<Idea>(Many {Text {word.c_str()}})};
+            forget.SetMass(-1);
+            ontology.Create(forget);
+            REQUIRE(forget.IsDone());
+         }
+      }
+      Teach(ontology, "star", 0, 20);
+      REQUIRE(ontology.GetIdeaCount() == 110);
+      kinship.Sign(ontology);
+
+      THEN("It is signed from scratch, as if it never knew the forgotten ideas") {
+         Ontology fresh;
+         Teach(fresh, "animal", 10, 100);
+         Teach(fresh, "star", 0, 20);
+         Kinship expected;
+         expected.Sign(fresh);
+         REQUIRE(*kinship.GetSignature(ontology) == *expected.GetSignature(fresh));
+         fresh.Teardown();
+      }
+
+      ontology.Teardown();
+   }
+}
@@ -0,0 +1,225 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/Ontology.hpp"
+#include <Langulus/Testing.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace fs = ::std::filesystem;
+
+
+/// Get a path in the temporary folder, removing anything left there by a     
+/// previous run                                                              
+///   @param name - name of the file                                          
+///   @return the path                                                        
+static auto Scratch(const char* name) -> fs::path {
+   const auto folder = fs::temp_directory_path() / "LangulusModAITest";
+   fs::create_directories(folder);
+   const auto path = folder / name;
+   fs::remove(path);
+   return path;
+}
+
+/// Convert a path to text                                                    
+///   @param path - the path                                                  
+///   @return the text                                                        
+static auto ToText(const fs::path& path) -> Text {
+   return Text {path.string().c_str()};
+}
+
+/// Read a whole file                                                         
+///   @param path - the file                                                  
+///   @return the contents                                                    
+static auto ReadFile(const fs::path& path) -> ::std::vector<char> {
+   ::std::ifstream file {path, ::std::ios::binary};
+   return {::std::istreambuf_iterator<char> {file}, ::std::istreambuf_iterator<char> {}};
+}
+
+/// Write a whole file                                                        
+///   @param path - the file                                                  
+///   @param contents - the contents                                          
+static void WriteFile(const fs::path& path, const ::std::vector<char>& contents) {
+   ::std::ofstream file {path, ::std::ios::binary};
+   file.write(contents.data(), static_cast<::std::streamsize>(contents.size()));
+}
+
+/// Learn a text idea                                                         
+///   @param ontology - the ontology to learn in                              
+///   @param text - the text                                                  
+///   @return the idea                                                        
+static auto Learn(Ontology& ontology, const char* text) -> Idea* {
+   return ontology.Build(Many {Text {text}});
+}
+
+/// Advance a paged ontology by one update cycle                              
+///   @param ontology - the ontology                                          
+static void Update(Ontology& ontology) {
+   const auto writer = ontology.Write();
+   ontology.Update();
+}
+
+SCENARIO("Paged ontologies", "[ai][paging]") {
+   GIVEN("An ontology saved in partitions of linked ideas") {
+      const auto path = Scratch("paged.ontology");
+      Many sequence;
+      sequence << Many {Text {"a1"}} << Many {Text {"a2"}};
+
+      // Three partitions - a1, a2 and the idea made of them, then b's, 
+      // then c's                                                       
+      {
+         Ontology source;
+         {
+            const auto writer = source.Write();
+            for (auto [one, two] : {::std::pair {"a1", "a2"},
+                                    ::std::pair {"b1", "b2"},
+                                    ::std::pair {"c1", "c2"}})
+               Learn(source, one)->Associate(Learn(source, two));
+            source.Build(sequence);
+         }
+
+         REQUIRE(source.SavePaged(ToText(path), 2));
+         source.Teardown();
+      }
+
+      Ontology paged;
+      REQUIRE(paged.Page(ToText(path), 2));
+      REQUIRE(paged.IsPaged());
+      REQUIRE(paged.GetIdeaCount() == 0);
+
+      WHEN("An idea is looked up") {
+         const auto writer = paged.Write();
+         auto a1 = Learn(paged, "a1");
+
+         THEN("Its whole partition is paged in, without duplicating anything") {
+            REQUIRE(paged.GetIdeaCount() == 3);
+            auto a2 = Learn(paged, "a2");
+            REQUIRE(a1->HasAssociation(a2));
+            REQUIRE(a2->HasAssociation(a1));
+            paged.Build(sequence);
+            REQUIRE(paged.GetIdeaCount() == 3);
+         }
+      }
+
+      WHEN("More is paged in than the budget allows, over several updates") {
+         {
+            const auto writer = paged.Write();
+            Learn(paged, "a1");
+            Learn(paged, "b1");
+         }
+         Update(paged);
+         REQUIRE(paged.GetIdeaCount() == 5);
+
+         {
+            const auto writer = paged.Write();
+            Learn(paged, "b1");
+         }
+         Update(paged);
+
+         THEN("The least recently used partition is evicted, and paged in again when needed") {
+            REQUIRE(paged.GetIdeaCount() == 2);
+
+            const auto writer = paged.Write();
+            auto a1 = Learn(paged, "a1");
+            REQUIRE(paged.GetIdeaCount() == 5);
+            REQUIRE(a1->HasAssociation(Learn(paged, "a2")));
+         }
+      }
+
+      WHEN("A paged idea is linked to something new") {
+         Idea* a1;
+         Idea* x;
+         {
+            const auto writer = paged.Write();
+            a1 = Learn(paged, "a1");
+            x = Learn(paged, "x");
+            a1->Associate(x);
+         }
+         Update(paged);
+
+         {
+            const auto writer = paged.Write();
+            Learn(paged, "b1");
+         }
+         Update(paged);
+
+         {
+            const auto writer = paged.Write();
+            Learn(paged, "c1");
+         }
+         Update(paged);
+
+         THEN("Its partition is pinned, and others are evicted instead") {
+            REQUIRE(paged.GetIdeaCount() == 6);
+
+            const auto writer = paged.Write();
+            REQUIRE(Learn(paged, "a1") == a1);
+            REQUIRE(a1->HasAssociation(x));
+            REQUIRE(paged.GetIdeaCount() == 6);
+         }
+      }
+
+      paged.Teardown();
+
+      WHEN("The file is corrupt") {
+         const auto original = ReadFile(path);
+         PagedTrailer trailer;
+         ::std::memcpy(&trailer, original.data() + original.size() - sizeof(trailer), sizeof(trailer));
+         const auto partitionAt = trailer.mPartitionsOffset
+            + (trailer.mPartitionCount - 1) * sizeof(PagedPartition);
+         const auto keyAt = trailer.mKeysOffset
+            + (trailer.mKeyCount - 1) * sizeof(PagedKey);
+
+         // Corrupt a copy of the file in place, and try paging it      
+         const auto pages = [&](auto&& corrupt) {
+            const auto copy = Scratch("corrupt.ontology");
+            auto contents = original;
+            corrupt(contents);
+            WriteFile(copy, contents);
+
+            Ontology ontology;
+            const bool accepted = ontology.Page(ToText(copy), 2);
+            REQUIRE(ontology.IsPaged() == accepted);
+            ontology.Teardown();
+            return accepted;
+         };
+
+         THEN("A partition outside the file is rejected") {
+            REQUIRE_FALSE(pages([&](::std::vector<char>& contents) {
+               PagedPartition partition;
+               ::std::memcpy(&partition, contents.data() + partitionAt, sizeof(partition));
+               partition.mSize = ~::std::uint64_t {0};
+               ::std::memcpy(contents.data() + partitionAt, &partition, sizeof(partition));
+            }));
+         }
+
+         THEN("A key of a partition that doesn't exist is rejected") {
+            REQUIRE_FALSE(pages([&](::std::vector<char>& contents) {
+               PagedKey key;
+               ::std::memcpy(&key, contents.data() + keyAt, sizeof(key));
+               key.mPartition = static_cast<::std::uint32_t>(trailer.mPartitionCount);
+               ::std::memcpy(contents.data() + keyAt, &key, sizeof(key));
+            }));
+         }
+
+         THEN("Tables that overflow the file are rejected") {
+            REQUIRE_FALSE(pages([&](::std::vector<char>& contents) {
+               auto broken = trailer;
+               broken.mKeyCount = ~::std::uint64_t {0} / sizeof(PagedKey) + 1;
+               ::std::memcpy(contents.data() + contents.size() - sizeof(broken), &broken, sizeof(broken));
+            }));
+         }
+
+         THEN("The intact file is accepted") {
+            REQUIRE(pages([](::std::vector<char>&) {}));
+         }
+      }
+   }
+}
@@ -0,0 +1,120 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+
+
+/// Create a mind in a module                                                 
+///   @param module - the module                                              
+///   @return the new mind                                                    
+static auto CreateMind(AI& module) -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   module.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+/// Make a verb that creates an idea                                          
+///   @tparam V - the verb, Create or Select                                  
+///   @param text - what the idea describes                                   
+///   @param mass - the mass of the verb                                      
+///   @param priority - the priority of the verb                              
+///   @return the verb                                                        
+template<CT::Verb V>
+static auto About(const char* text, Real mass = 1, Real priority = 0) -> V {
+   V verb {Construct::From<Idea>(Many {Text {text}})};
+   verb.SetMass(mass);
+   verb.SetPriority(priority);
+   return verb;
+}
+
+/// Make a mind do something, and tell what came out of it                    
+///   @param mind - the mind                                                  
+///   @param verb - the verb to do                                            
+///   @return whether the verb was recorded, and whether it was dispatched    
+template<class V>
+static auto Witness(Mind& mind, V&& verb) -> ::std::pair<bool, bool> {
+   const auto recorded = mind.GetHistory().GetNext();
+   mind.Do(verb);
+   return {mind.GetHistory().GetNext() != recorded, verb.IsDone()};
+}
+
+SCENARIO("Perceiving events", "[ai][perception]") {
+   GIVEN("A perception filter") {
+      Perception perception;
+      const auto create = About<Verbs::Create>("a");
+      const auto select = About<Verbs::Select>("a");
+
+      WHEN("The verbs it perceives are changed, after it has filtered the same verb") {
+         perception.Only<Verbs::Create>();
+         REQUIRE(perception.Perceives(create));
+         REQUIRE_FALSE(perception.Perceives(select));
+
+         perception.Ignore<Verbs::Create>();
+
+         THEN("The cached verdict is dropped") {
+            REQUIRE_FALSE(perception.Perceives(create));
+            REQUIRE(perception.Perceives(select));
+         }
+      }
+
+      WHEN("Thresholds are set") {
+         perception.MinMass(2).MinPriority(1);
+
+         THEN("Weaker and less important events aren't perceived, whatever their verb") {
+            REQUIRE_FALSE(perception.Perceives(About<Verbs::Create>("a", 1, 1)));
+            REQUIRE_FALSE(perception.Perceives(About<Verbs::Create>("a", 2, 0)));
+            REQUIRE(perception.Perceives(About<Verbs::Create>("a", 2, 1)));
+            REQUIRE(perception.Perceives(About<Verbs::Create>("a", -2, 1)));
+         }
+      }
+   }
+
+   GIVEN("A mind") {
+      AI module {nullptr, Many {}};
+      auto mind = CreateMind(module);
+      const auto& ontology = mind->GetOntology();
+      const auto known = ontology.GetIdeaCount();
+
+      WHEN("It perceives only some verbs") {
+         mind->SetPerception(Perception {}.Only<Verbs::Create>());
+
+         THEN("Only those are recorded and dispatched") {
+            REQUIRE(Witness(*mind, About<Verbs::Create>("a")) == ::std::pair {true, true});
+            REQUIRE(Witness(*mind, About<Verbs::Select>("b")) == ::std::pair {false, false});
+            REQUIRE(mind->GetHistory().GetCount() == 1);
+            REQUIRE(mind->GetHistory().GetType(0) == MetaVerbOf<Verbs::Create>());
+            REQUIRE(ontology.GetIdeaCount() == known + 1);
+         }
+
+         THEN("Switching the filter changes what is perceived right away") {
+            REQUIRE(Witness(*mind, About<Verbs::Create>("a")) == ::std::pair {true, true});
+            mind->SetPerception(Perception {}.Ignore<Verbs::Create>());
+            REQUIRE(Witness(*mind, About<Verbs::Create>("b")) == ::std::pair {false, false});
+            REQUIRE(Witness(*mind, About<Verbs::Select>("c")) == ::std::pair {true, true});
+            mind->SetPerception(Perception {});
+            REQUIRE(Witness(*mind, About<Verbs::Create>("d")) == ::std::pair {true, true});
+            REQUIRE(mind->GetHistory().GetCount() == 3);
+            REQUIRE(ontology.GetIdeaCount() == known + 3);
+         }
+      }
+
+      WHEN("It ignores weak or unimportant events") {
+         mind->SetPerception(Perception {}.MinMass(2).MinPriority(1));
+
+         THEN("Those are neither recorded, nor dispatched") {
+            REQUIRE(Witness(*mind, About<Verbs::Create>("a", 1, 1)) == ::std::pair {false, false});
+            REQUIRE(Witness(*mind, About<Verbs::Create>("b", 2, 0)) == ::std::pair {false, false});
+            REQUIRE(Witness(*mind, About<Verbs::Create>("c", 2, 1)) == ::std::pair {true, true});
+            REQUIRE(mind->GetHistory().GetCount() == 1);
+            REQUIRE(ontology.GetIdeaCount() == known + 1);
+         }
+      }
+
+      module.Teardown();
+   }
+}
@@ -0,0 +1,214 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+#include <vector>
+
+
+/// Everything a flow did, in order                                           
+using Trace = ::std::vector<Many>;
+
+/// Run a nested flow, the way Mind::Compile nests it - groups are done in    
+/// order, and alternatives are attempted in order, until one succeeds        
+///   @param flow - the flow to run                                           
+///   @param call - function that does a single step, returning true on success
+///   @return true if the flow succeeded                                      
+template<class F>
+static bool Walk(const Many& flow, F&& call) {
+   const bool fork = flow.IsOr() and flow.GetCount() > 1;
+   bool ok = not fork;
+   const auto step = [&](bool done) {
+      ok = done;
+      return fork ? not done : done;
+   };
+
+   if (flow.IsDeep()) {
+      flow.ForEach([&](const Many& group) {
+         return step(Walk(group, call)) ? Loop::Continue : Loop::Break;
+      });
+   }
+   else if (flow.Is<Verb>()) {
+      flow.ForEach([&](const Verb& verb) {
+         return step(call(verb)) ? Loop::Continue : Loop::Break;
+      });
+   }
+   else if (flow.IsSimilar<Idea*>()) {
+      flow.ForEach([&](const Idea* idea) {
+         return step(call(idea)) ? Loop::Continue : Loop::Break;
+      });
+   }
+   else ok = call(flow);
+   return ok;
+}
+
+/// Make a function that records each step in a trace, and fails the steps    
+/// that match a predicate                                                    
+///   @param trace - [out] the trace to record to                             
+///   @param fails - the predicate, invoked with the recorded step            
+///   @return the function, to run a program or walk a flow with              
+template<class P>
+static auto Record(Trace& trace, P&& fails) {
+   return [&trace, fails](const auto& step) {
+      trace.emplace_back(Many {step});
+      return not fails(trace.back());
+   };
+}
+
+/// Make a flow of groups                                                     
+///   @param alternatives - whether the groups are mutually exclusive         
+///   @param groups - the groups                                              
+///   @return the flow                                                        
+static auto Flow(bool alternatives, ::std::initializer_list<Many> groups) -> Many {
+   Many flow;
+   for (auto& group : groups)
+      flow << group;
+   if (alternatives)
+      flow.MakeOr();
+   return flow;
+}
+
+/// Create a mind in a module                                                 
+///   @param module - the module                                              
+///   @return the new mind                                                    
+static auto CreateMind(AI& module) -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   module.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+SCENARIO("Running flat programs", "[ai][program]") {
+   GIVEN("A fork that fails, nested in a branch of another fork") {
+      // a, (b, (x | y) | c), d                                         
+      const auto flow = Flow(false, {
+         Many {Text {"a"}},
+         Flow(true, {
+            Flow(false, {
+               Many {Text {"b"}},
+               Flow(true, {Many {Text {"x"}}, Many {Text {"y"}}})
+            }),
+            Many {Text {"c"}}
+         }),
+         Many {Text {"d"}}
+      });
+
+      Program program;
+      program.Emit(flow);
+
+      WHEN("Both alternatives of the inner fork fail") {
+         const auto fails = [](const Many& step) {
+            return step == Many {Text {"x"}} or step == Many {Text {"y"}};
+         };
+
+         Trace ran, walked;
+         const bool result = program.Run(Record(ran, fails));
+
+         THEN("The outer fork falls back to its next branch, as the nested flow does") {
+            REQUIRE(result);
+            REQUIRE(Walk(flow, Record(walked, fails)));
+            REQUIRE(ran == walked);
+            REQUIRE(ran.size() == 6);
+            REQUIRE(ran[4] == Many {Text {"c"}});
+         }
+      }
+
+      WHEN("Every alternative fails") {
+         const auto fails = [](const Many& step) {
+            return step != Many {Text {"a"}} and step != Many {Text {"b"}};
+         };
+
+         Trace ran, walked;
+         const bool result = program.Run(Record(ran, fails));
+
+         THEN("The whole program fails, as the nested flow does") {
+            REQUIRE_FALSE(result);
+            REQUIRE_FALSE(Walk(flow, Record(walked, fails)));
+            REQUIRE(ran == walked);
+         }
+      }
+   }
+
+   GIVEN("Forks nested deeper than a program runs without allocating") {
+      // ((... ((fail | fail) | n-1) ...) | 1) | 0                      
+      static constexpr Count Depth = Program::MaxDepth + 8;
+      auto flow = Flow(true, {Many {Text {"fail"}}, Many {Text {"fail"}}});
+      for (Count level = Depth - 1; level > 0; --level) {
+         const auto name = ::std::to_string(level - 1);
+         flow = Flow(true, {flow, Many {Text {name.c_str()}}});
+      }
+
+      Program program;
+      program.Emit(flow);
+
+      WHEN("Everything fails, except the outermost alternative") {
+         const auto fails = [](const Many& step) {
+            return step != Many {Text {"0"}};
+         };
+
+         Trace ran, walked;
+         const bool result = program.Run(Record(ran, fails));
+
+         THEN("Every fork falls back in turn, as the nested flow does") {
+            REQUIRE(result);
+            REQUIRE(Walk(flow, Record(walked, fails)));
+            REQUIRE(ran == walked);
+            REQUIRE(ran.size() == Depth + 1);
+            REQUIRE(ran.back() == Many {Text {"0"}});
+         }
+      }
+   }
+
+   GIVEN("A mind that knows words that can be interpreted in many ways") {
+      AI module {nullptr, Many {}};
+      auto mind = CreateMind(module);
+      {
+         auto& ontology = mind->GetOntology();
+         const auto writer = ontology.Write();
+         const auto action = ontology.Build(Many {Code {"create Thing"}});
+         for (auto word : {"thing", "things", "create", "creature", "a", "an"}) {
+            const Text text {word};
+            for (Offset i = 1; i <= text.GetCount(); ++i) {
+               const auto idea = ontology.Build(Many {Text {text.Select(0, i)}});
+               if (i == text.GetCount() and text.GetCount() > 2)
+                  idea->Associate(action);
+            }
+         }
+      }
+
+      const Text text {"create a creature and an thing"};
+
+      WHEN("The text is interpreted into a program, and into a nested flow") {
+         Program program;
+         mind->Interpret(text, program);
+         const auto flow = mind->Interpret(text);
+
+         THEN("Both do the same, even when every mention fails") {
+            const auto fails = [](const Many& step) {
+               return step.IsSimilar<Idea*>();
+            };
+
+            Trace ran, walked;
+            REQUIRE(program.Run(Record(ran, fails)) == Walk(flow, Record(walked, fails)));
+            REQUIRE(ran == walked);
+            REQUIRE_FALSE(ran.empty());
+         }
+
+         THEN("Compiling the interpretations directly gives the same program") {
+            Program compiled;
+            mind->Compile(mind->GetOntology().Interpret(text), compiled);
+            Trace ran, again;
+            const auto none = [](const Many&) { return false; };
+            REQUIRE(program.Run(Record(ran, none)));
+            REQUIRE(compiled.Run(Record(again, none)));
+            REQUIRE(ran == again);
+         }
+      }
+
+      module.Teardown();
+   }
+}
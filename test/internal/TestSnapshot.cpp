@@ -0,0 +1,258 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/inner/Ontology.hpp"
+#include "../../source/inner/Snapshot.hpp"
+#include <Langulus/Testing.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+/// Load an image in a new ontology, and check that nothing was learned if    
+/// loading failed                                                            
+///   @param image - the image to load                                        
+///   @return true if the image was loaded                                    
+static bool LoadsCleanly(const ::std::vector<Byte>& image) {
+   Ontology ontology;
+   bool loaded;
+   {
+      const auto writer = ontology.Write();
+      loaded = ontology.Load(image.data(), image.size());
+   }
+
+   if (not loaded)
+      REQUIRE(ontology.GetIdeaCount() == 0);
+   ontology.Teardown();
+   return loaded;
+}
+
+SCENARIO("Ontology snapshots", "[ai][snapshot]") {
+   GIVEN("An ontology with a few linked ideas") {
+      Ontology ontology;
+      {
+         const auto writer = ontology.Write();
+         auto one   = ontology.Build(Many {Text {"one"}});
+         auto two   = ontology.Build(Many {Text {"two"}});
+         auto three = ontology.Build(Many {Text {"three"}});
+         one->Associate(two);
+         one->Disassociate(three);
+      }
+
+      const auto saved = ontology.Save();
+      REQUIRE(saved);
+      const ::std::vector<Byte> image {saved.GetRaw(), saved.GetRaw() + saved.GetCount()};
+
+      SnapshotHeader header;
+      ::std::memcpy(&header, image.data(), sizeof(header));
+      REQUIRE(header.mIdeaCount == ontology.GetIdeaCount());
+      REQUIRE(header.mEdgeCount > 0);
+
+      WHEN("The image is loaded in another ontology") {
+         Ontology copy;
+         {
+            const auto writer = copy.Write();
+            REQUIRE(copy.Load(image.data(), image.size()));
+         }
+
+         THEN("The same ideas and links are restored") {
+            REQUIRE(copy.GetIdeaCount() == ontology.GetIdeaCount());
+            for (Offset i = 0; i < copy.GetIdeaCount(); ++i)
+               REQUIRE(copy.GetIdeaHash(i) == ontology.GetIdeaHash(i));
+
+            const auto writer = copy.Write();
+            auto one   = copy.Build(Many {Text {"one"}});
+            auto two   = copy.Build(Many {Text {"two"}});
+            auto three = copy.Build(Many {Text {"three"}});
+            REQUIRE(copy.GetIdeaCount() == ontology.GetIdeaCount());
+            REQUIRE(one->HasAssociation(two));
+            REQUIRE(one->HasDisassociation(three));
+            REQUIRE_FALSE(one->HasAssociation(three));
+         }
+
+         copy.Teardown();
+      }
+
+      WHEN("The image is loaded from an unaligned address") {
+         ::std::vector<Byte> unaligned(image.size() + 1);
+         ::std::memcpy(unaligned.data() + 1, image.data(), image.size());
+
+         THEN("It is loaded just the same") {
+            Ontology copy;
+            {
+               const auto writer = copy.Write();
+               REQUIRE(copy.Load(unaligned.data() + 1, image.size()));
+            }
+            REQUIRE(copy.GetIdeaCount() == ontology.GetIdeaCount());
+            copy.Teardown();
+         }
+      }
+
+      WHEN("The image is truncated") {
+         THEN("Loading fails without learning anything") {
+            for (Size cut : {Size {0}, sizeof(SnapshotHeader) - 1,
+                             sizeof(SnapshotHeader), image.size() / 2,
+                             image.size() - 1}) {
+               const ::std::vector<Byte> truncated {image.begin(), image.begin() + cut};
+               REQUIRE_FALSE(LoadsCleanly(truncated));
+            }
+         }
+      }
+
+      WHEN("The header's counts overflow when multiplied by record sizes") {
+         auto corrupt = image;
+         auto broken = header;
+         broken.mIdeaCount = ~::std::uint64_t {0} / sizeof(SnapshotIdea) + 1;
+         ::std::memcpy(corrupt.data(), &broken, sizeof(broken));
+
+         THEN("Loading fails without learning anything") {
+            REQUIRE_FALSE(LoadsCleanly(corrupt));
+         }
+      }
+
+      WHEN("The blob section's offset overflows when added to its size") {
+         auto corrupt = image;
+         auto broken = header;
+         broken.mBlobsOffset = ~::std::uint64_t {0} - 4;
+         ::std::memcpy(corrupt.data(), &broken, sizeof(broken));
+
+         THEN("Loading fails without learning anything") {
+            REQUIRE_FALSE(LoadsCleanly(corrupt));
+         }
+      }
+
+      WHEN("The last link refers to an idea outside the idea table") {
+         auto corrupt = image;
+         SnapshotEdge edge;
+         const auto at = header.mEdgesOffset + (header.mEdgeCount - 1) * sizeof(SnapshotEdge);
+         ::std::memcpy(&edge, corrupt.data() + at, sizeof(edge));
+         edge.mTo = static_cast<::std::uint32_t>(header.mIdeaCount);
+         ::std::memcpy(corrupt.data() + at, &edge, sizeof(edge));
+
+         THEN("Loading fails without creating any of the valid ideas") {
+            REQUIRE_FALSE(LoadsCleanly(corrupt));
+         }
+      }
+
+      WHEN("The last idea's descriptor is outside the blob section") {
+         auto corrupt = image;
+         SnapshotIdea record;
+         const auto at = header.mIdeasOffset + (header.mIdeaCount - 1) * sizeof(SnapshotIdea);
+         ::std::memcpy(&record, corrupt.data() + at, sizeof(record));
+         record.mBlobOffset = header.mBlobsSize;
+         record.mBlobSize = ~::std::uint64_t {0};
+         ::std::memcpy(corrupt.data() + at, &record, sizeof(record));
+
+         THEN("Loading fails without creating any of the valid ideas") {
+            REQUIRE_FALSE(LoadsCleanly(corrupt));
+         }
+      }
+
+      ontology.Teardown();
+   }
+
+   GIVEN("An ontology with ideas made of other ideas") {
+      Many sequence;
+      sequence << Many {Text {"one"}} << Many {Text {"two"}};
+      Many alternatives;
+      alternatives << Many {Text {"two"}} << Many {Text {"three"}};
+      alternatives.MakeOr();
+
+      Ontology ontology;
+      {
+         const auto writer = ontology.Write();
+         ontology.Build(Many {Text {"zero"}});
+         auto pair = ontology.Build(sequence);
+         auto either = ontology.Build(alternatives);
+         pair->Associate(either);
+
+         // Forgetting the first idea moves the last one in its place,  
+         // so that an idea now comes before the ideas it is made of    
+         Verbs::Create forget {Construct::From<Idea>(Many {Text {"zero"}})};
+         forget.SetMass(-1);
+         ontology.Create(forget);
+         REQUIRE(forget.IsDone());
+      }
+
+      const auto saved = ontology.Save();
+      REQUIRE(saved);
+      const ::std::vector<Byte> image {saved.GetRaw(), saved.GetRaw() + saved.GetCount()};
+
+      SnapshotHeader header;
+      ::std::memcpy(&header, image.data(), sizeof(header));
+
+      WHEN("The image is loaded in another ontology") {
+         Ontology copy;
+         {
+            const auto writer = copy.Write();
+            REQUIRE(copy.Load(image.data(), image.size()));
+         }
+
+         THEN("The same ideas are restored in the same order, made of the same parts") {
+            REQUIRE(copy.GetIdeaCount() == ontology.GetIdeaCount());
+            for (Offset i = 0; i < copy.GetIdeaCount(); ++i)
+               REQUIRE(copy.GetIdeaHash(i) == ontology.GetIdeaHash(i));
+
+            const auto writer = copy.Write();
+            auto pair = copy.Build(sequence);
+            auto either = copy.Build(alternatives);
+            REQUIRE(copy.GetIdeaCount() == ontology.GetIdeaCount());
+            REQUIRE(pair->HasAssociation(either));
+            REQUIRE(either->HasAssociation(pair));
+         }
+
+         copy.Teardown();
+      }
+
+      WHEN("The same ideas are learned by another ontology, in another order") {
+         Ontology other;
+         {
+            const auto writer = other.Write();
+            other.Build(alternatives);
+            other.Build(sequence);
+         }
+
+         THEN("They have the same hashes, even though their parts are elsewhere") {
+            ::std::vector<::std::uint64_t> mine, theirs;
+            for (Offset i = 0; i < ontology.GetIdeaCount(); ++i)
+               mine.push_back(ontology.GetIdeaHash(i));
+            for (Offset i = 0; i < other.GetIdeaCount(); ++i)
+               theirs.push_back(other.GetIdeaHash(i));
+
+            ::std::sort(mine.begin(), mine.end());
+            ::std::sort(theirs.begin(), theirs.end());
+            REQUIRE(mine == theirs);
+         }
+
+         other.Teardown();
+      }
+
+      WHEN("An idea is made of itself") {
+         auto corrupt = image;
+         for (::std::uint64_t i = 0; i < header.mIdeaCount; ++i) {
+            SnapshotIdea record;
+            ::std::memcpy(&record, corrupt.data() + header.mIdeasOffset
+               + i * sizeof(SnapshotIdea), sizeof(record));
+
+            SnapshotDescriptor head;
+            const auto at = header.mBlobsOffset + record.mBlobOffset;
+            ::std::memcpy(&head, corrupt.data() + at, sizeof(head));
+            if (head.mKind == SnapshotDescriptor::Data)
+               continue;
+
+            const auto self = static_cast<::std::uint32_t>(i);
+            ::std::memcpy(corrupt.data() + at + sizeof(head), &self, sizeof(self));
+         }
+
+         THEN("Loading fails without learning anything") {
+            REQUIRE_FALSE(LoadsCleanly(corrupt));
+         }
+      }
+
+      ontology.Teardown();
+   }
+}
@@ -0,0 +1,347 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+#include <future>
+#include <string>
+#include <vector>
+
+
+/// Get the first idea mentioned in an interpretation                         
+///   @param interpretation - the interpretation                              
+///   @return the idea, or nullptr if none is mentioned                       
+static auto FirstIdea(const Many& interpretation) -> const Idea* {
+   const Idea* found = nullptr;
+   interpretation.ForEachDeep([&](Idea* mentioned) {
+      if (not found)
+         found = mentioned;
+   });
+   return found;
+}
+
+/// Check if an interpretation mentions an idea anywhere                      
+///   @param interpretation - the interpretation                              
+///   @param idea - the idea to look for                                      
+///   @return true if the idea is mentioned                                   
+static bool Mentions(const Many& interpretation, const Idea* idea) {
+   bool found = false;
+   interpretation.ForEachDeep([&](Idea* mentioned) {
+      if (mentioned == idea)
+         found = true;
+   });
+   return found;
+}
+
+/// Create a mind in a module                                                 
+///   @param module - the module                                              
+///   @return the new mind                                                    
+static auto CreateMind(AI& module) -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   module.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+SCENARIO("Layered ontologies", "[ai][society]") {
+   GIVEN("An ontology layered over a shared one") {
+      Ontology shared;
+      Idea* one;
+      Idea* two;
+      {
+         const auto writer = shared.Write();
+         one = shared.Build(Many {Text {"one"}});
+         two = shared.Build(Many {Text {"two"}});
+         one->Associate(two);
+      }
+
+      Ontology local;
+      {
+         const auto writer = local.Write();
+         local.Share(shared);
+      }
+
+      WHEN("Something only the shared ontology knows is interpreted") {
+         const auto interpretation = local.Interpret(Text {"one"});
+
+         THEN("The shared idea is found, without being learned locally") {
+            REQUIRE(Mentions(interpretation, one));
+            REQUIRE(local.GetIdeaCount() == 0);
+         }
+      }
+
+      WHEN("Something is learned about a shared idea") {
+         Idea* shadow;
+         Idea* three;
+         {
+            const auto writer = local.Write();
+            shadow = local.Build(Many {Text {"one"}});
+            three = local.Build(Many {Text {"three"}});
+            shadow->Associate(three);
+         }
+
+         THEN("It is learned by a local shadow, that inherits the shared links") {
+            REQUIRE(shadow != one);
+            REQUIRE(shadow->GetOntology() == &local);
+            REQUIRE(shadow->HasAssociation(three));
+            REQUIRE(shadow->HasAssociation(two));
+         }
+
+         THEN("The shared idea remains untouched") {
+            REQUIRE_FALSE(one->HasAssociation(three));
+            REQUIRE(one->GetAssociations().GetCount() == 1);
+         }
+      }
+
+      WHEN("Another ontology is layered over the local one") {
+         Idea* shadow;
+         {
+            const auto writer = local.Write();
+            shadow = local.Build(Many {Text {"two"}});
+         }
+
+         Ontology top;
+         Idea* inherited;
+         {
+            const auto writer = top.Write();
+            top.Share(local);
+            inherited = top.Build(Many {Text {"one"}});
+         }
+
+         THEN("Shared ideas two layers down are substituted with the shadows in between") {
+            REQUIRE(inherited->HasAssociation(shadow));
+         }
+
+         top.Teardown();
+      }
+
+      WHEN("The shared ontology is no longer shared") {
+         Idea* shadow;
+         {
+            const auto writer = local.Write();
+            shadow = local.Build(Many {Text {"one"}});
+            local.Unshare(shared);
+         }
+
+         THEN("Shared ideas are neither found, nor inherited anymore") {
+            REQUIRE_FALSE(local.IsSharing(&shared));
+            REQUIRE_FALSE(Mentions(local.Interpret(Text {"two"}), two));
+            REQUIRE_FALSE(shadow->HasAssociation(two));
+         }
+      }
+
+      local.Teardown();
+      shared.Teardown();
+   }
+
+   GIVEN("A reader viewing an ontology, while it begins sharing another") {
+      Ontology shared;
+      Idea* two;
+      {
+         const auto writer = shared.Write();
+         auto one = shared.Build(Many {Text {"one"}});
+         two = shared.Build(Many {Text {"two"}});
+         one->Associate(two);
+      }
+
+      Ontology local;
+      Idea* one;
+      {
+         const auto writer = local.Write();
+         one = local.Build(Many {Text {"one"}});
+      }
+
+      ::std::promise<void> viewing;
+      ::std::promise<void> layered;
+      auto reader = ::std::async(::std::launch::async, [&] {
+         const auto view = local.Read();
+         viewing.set_value();
+         layered.get_future().wait();
+         return Mentions(local.Interpret(Text {"two"}), two)
+             or one->HasAssociation(two);
+      });
+
+      viewing.get_future().wait();
+      {
+         const auto writer = local.Write();
+         local.Share(shared);
+      }
+      layered.set_value();
+
+      THEN("The reader doesn't see the shared ontology") {
+         REQUIRE_FALSE(reader.get());
+      }
+
+      THEN("A new reader sees it, and its links") {
+         const auto seen = ::std::async(::std::launch::async, [&] {
+            const auto view = local.Read();
+            return Mentions(local.Interpret(Text {"two"}), two)
+               and one->HasAssociation(two);
+         }).get();
+         REQUIRE(seen);
+         reader.get();
+      }
+
+      local.Teardown();
+      shared.Teardown();
+   }
+}
+
+SCENARIO("Promoting what most members of a society know", "[ai][society]") {
+   GIVEN("Three minds with most of their vocabulary in common") {
+      AI module {nullptr, Many {}};
+      module.SetKinship(0.5, 3, 1);
+
+      Mind* minds[3];
+      Count before[3];
+      Idea* secret = nullptr;
+      for (Offset m = 0; m < 3; ++m) {
+         minds[m] = CreateMind(module);
+         auto& ontology = minds[m]->GetOntology();
+         const auto writer = ontology.Write();
+         for (Count i = 0; i < 32; ++i) {
+            const auto word = "word" + ::std::to_string(i);
+            ontology.Build(Many {Text {word.c_str()}});
+         }
+
+         // Only the first mind links two of the words, and only it     
+         // knows a secret                                              
+         if (m == 0) {
+            auto zero = ontology.Build(Many {Text {"word0"}});
+            zero->Associate(ontology.Build(Many {Text {"word1"}}));
+            secret = ontology.Build(Many {Text {"secret"}});
+         }
+         before[m] = ontology.GetIdeaCount();
+      }
+
+      WHEN("They are gathered into a society") {
+         module.Update({});
+
+         const auto& societies = minds[0]->GetSocieties();
+         REQUIRE(societies.GetCount() == 1);
+         const auto society = societies[0];
+
+         THEN("All of them are members") {
+            REQUIRE(minds[1]->GetSocieties() == societies);
+            REQUIRE(minds[2]->GetSocieties() == societies);
+         }
+
+         THEN("The common vocabulary is kept once, in the shared ontology") {
+            REQUIRE(society->GetOntology().GetIdeaCount() >= 32);
+            for (auto mind : minds) {
+               const auto& ontology = mind->GetOntology();
+               const auto zero = FirstIdea(ontology.Interpret(Text {"word0"}));
+               REQUIRE(zero);
+               REQUIRE(zero->GetOntology() == &society->GetOntology());
+            }
+            for (Offset m = 0; m < 3; ++m)
+               REQUIRE(minds[m]->GetOntology().GetIdeaCount() + 32 <= before[m]);
+         }
+
+         THEN("What only one member knows stays private") {
+            REQUIRE(Mentions(minds[0]->GetOntology().Interpret(Text {"secret"}), secret));
+            REQUIRE(secret->GetOntology() == &minds[0]->GetOntology());
+            for (auto mind : {minds[1], minds[2]})
+               REQUIRE_FALSE(Mentions(mind->GetOntology().Interpret(Text {"secret"}), secret));
+         }
+
+         THEN("Links between promoted ideas are shared with everyone") {
+            const auto& ontology = minds[2]->GetOntology();
+            const auto zero = FirstIdea(ontology.Interpret(Text {"word0"}));
+            const auto one = FirstIdea(ontology.Interpret(Text {"word1"}));
+            REQUIRE(zero->HasAssociation(one));
+         }
+      }
+
+      module.Teardown();
+   }
+}
+
+/// Create minds that know the same words, and gather them into a society     
+///   @param module - the module                                              
+///   @param minds - [out] the minds to create                                
+///   @param count - the number of minds                                      
+static void FormSociety(AI& module, Mind** minds, Count count) {
+   module.SetKinship(0.5, count, 1);
+   for (Offset m = 0; m < count; ++m) {
+      minds[m] = CreateMind(module);
+      auto& ontology = minds[m]->GetOntology();
+      const auto writer = ontology.Write();
+      for (Count i = 0; i < 32; ++i) {
+         const auto word = "word" + ::std::to_string(i);
+         ontology.Build(Many {Text {word.c_str()}});
+      }
+   }
+
+   module.Update({});
+   module.SetKinship(0.5, count, 0);
+}
+
+SCENARIO("Chronicling what members witness", "[ai][society]") {
+   GIVEN("A society of four minds") {
+      AI module {nullptr, Many {}};
+      Mind* minds[4];
+      FormSociety(module, minds, 4);
+      REQUIRE(minds[0]->GetSocieties().GetCount() == 1);
+      const auto society = minds[0]->GetSocieties()[0];
+      REQUIRE(society->GetMinds().GetCount() == 4);
+
+      WHEN("Each does something different, and all witness one event") {
+         ::std::vector<Verbs::Create> actions;
+         for (Offset m = 0; m < 4; ++m) {
+            const auto word = "action" + ::std::to_string(m);
+            actions.emplace_back(Construct::From<Idea>(Many {Text {word.c_str()}}));
+         }
+         Verbs::Create common {Construct::From<Idea>(Many {Text {"common"}})};
+
+         for (Offset m = 0; m < 4; ++m) {
+            minds[m]->Do(actions[m]);
+            minds[m]->Do(common);
+         }
+         module.Update({});
+
+         THEN("Only the common event is stored in the society") {
+            REQUIRE(society->GetHistory().GetCount() == 1);
+            REQUIRE(society->GetHistory().GetVerb(0) == common);
+         }
+
+         THEN("Each member remembers its own action privately, in order") {
+            for (Offset m = 0; m < 4; ++m) {
+               const auto& history = minds[m]->GetHistory();
+               REQUIRE(history.GetCount() == 2);
+               REQUIRE(history.GetVerb(0) == actions[m]);
+               REQUIRE(history.GetVerb(1) == common);
+            }
+         }
+      }
+
+      WHEN("Two members keep witnessing the same events for longer than the society's budget") {
+         Verbs::Create first {Construct::From<Idea>(Many {Text {"first"}})};
+         minds[2]->Do(first);
+         minds[3]->Do(first);
+         module.Update({});
+
+         const auto budget = society->GetHistory().GetBudget().mRecent;
+         for (Count frame = 0; frame < budget + 64; ++frame) {
+            const auto word = "event" + ::std::to_string(frame);
+            Verbs::Create event {Construct::From<Idea>(Many {Text {word.c_str()}})};
+            minds[0]->Do(event);
+            minds[1]->Do(event);
+            module.Update({});
+         }
+
+         THEN("The event the others still refer to is kept in the society") {
+            REQUIRE(society->GetHistory().GetCount() > budget);
+            for (auto mind : {minds[2], minds[3]}) {
+               REQUIRE(mind->GetHistory().GetCount() == 1);
+               REQUIRE(mind->GetHistory().GetVerb(0) == first);
+            }
+         }
+      }
+
+      module.Teardown();
+   }
+}
@@ -0,0 +1,85 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+#include <chrono>
+
+
+/// Teach a mind a few words, and all their prefixes, so that the text below  
+/// can be interpreted in many ways                                           
+///   @param mind - the mind to teach                                         
+static void Teach(Mind& mind) {
+   auto& ontology = mind.GetOntology();
+   const auto writer = ontology.Write();
+   for (auto word : {"thing", "things", "create", "creature", "a", "an"}) {
+      const Text text {word};
+      for (Offset i = 1; i <= text.GetCount(); ++i)
+         ontology.Build(Many {Text {text.Select(0, i)}});
+   }
+}
+
+/// Create a mind in a module                                                 
+///   @param module - the module                                              
+///   @return the new mind                                                    
+static auto CreateMind(AI& module) -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   module.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+SCENARIO("Gradual interpretation", "[ai][thought]") {
+   GIVEN("Two minds that know the same words") {
+      AI module {nullptr, Many {}};
+      auto eager = CreateMind(module);
+      auto gradual = CreateMind(module);
+      Teach(*eager);
+      Teach(*gradual);
+
+      const Text text {"create a creature and an ancient thing with things"};
+
+      WHEN("One interprets at once, and the other in tiny steps") {
+         const auto expected = eager->Interpret(text);
+
+         gradual->SetThinkingBudget(::std::chrono::microseconds {0});
+         const auto thought = gradual->InterpretLater(text);
+         Count updates = 0;
+         while (not thought->IsDone()) {
+            gradual->Update({});
+            ++updates;
+            REQUIRE(updates <= 100 * text.GetCount());
+         }
+
+         THEN("Both arrive at the same result, over many updates") {
+            REQUIRE(updates > text.GetCount());
+            REQUIRE(thought->GetResult() == expected);
+         }
+      }
+
+      WHEN("Something is learned while interpreting in tiny steps") {
+         gradual->SetThinkingBudget(::std::chrono::microseconds {0});
+         const auto thought = gradual->InterpretLater(text);
+         for (Count i = 0; i < text.GetCount() / 2; ++i)
+            gradual->Update({});
+
+         for (auto mind : {eager, gradual}) {
+            auto& ontology = mind->GetOntology();
+            const auto writer = ontology.Write();
+            ontology.Build(Many {Text {"ancient"}});
+         }
+
+         while (not thought->IsDone())
+            gradual->Update({});
+
+         THEN("The result is the same as interpreting after learning") {
+            REQUIRE(thought->GetResult() == eager->Interpret(text));
+         }
+      }
+
+      module.Teardown();
+   }
+}
@@ -0,0 +1,164 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+
+
+/// Learn a text idea                                                         
+///   @param ontology - the ontology to learn in                              
+///   @param text - the text                                                  
+///   @return the idea                                                        
+static auto Learn(Ontology& ontology, const char* text) -> Idea* {
+   return ontology.Build(Many {Text {text}});
+}
+
+/// Make a list of ideas to transfer                                          
+///   @param ideas - the ideas                                                
+///   @return the list                                                        
+static auto Roots(::std::initializer_list<Idea*> ideas) -> Ideas {
+   Ideas roots;
+   for (auto idea : ideas)
+      roots << idea;
+   return roots;
+}
+
+/// Create a mind in a module                                                 
+///   @param module - the module                                              
+///   @return the new mind                                                    
+static auto CreateMind(AI& module) -> Mind* {
+   Verbs::Create creation {Construct::From<Mind>()};
+   module.Create(creation);
+   return creation.GetOutput().template As<Mind*>();
+}
+
+SCENARIO("Transferring ideas between ontologies", "[ai][transfer]") {
+   GIVEN("A chain of linked ideas, and an idea made of two of them") {
+      // a - b - c - d, a x, and (a, b)                                 
+      Many sequence;
+      sequence << Many {Text {"a"}} << Many {Text {"b"}};
+
+      Ontology teacher;
+      Idea* a;
+      Idea* composite;
+      {
+         const auto writer = teacher.Write();
+         a = Learn(teacher, "a");
+         a->Associate(Learn(teacher, "b"));
+         Learn(teacher, "b")->Associate(Learn(teacher, "c"));
+         Learn(teacher, "c")->Associate(Learn(teacher, "d"));
+         a->Disassociate(Learn(teacher, "x"));
+         composite = teacher.Build(sequence);
+      }
+
+      Ontology pupil;
+
+      WHEN("Ideas are transferred to an ontology that already knows some of them") {
+         const auto writer = pupil.Write();
+         const auto knownA = Learn(pupil, "a");
+         const auto knownC = Learn(pupil, "c");
+         const auto learned = pupil.Transfer(teacher, Roots({a}), 100);
+
+         THEN("Known ideas are reused, instead of duplicated by descriptor") {
+            REQUIRE(learned.GetCount() == 1);
+            REQUIRE(learned[0] == knownA);
+            REQUIRE(pupil.GetIdeaCount() == 5);
+            REQUIRE(Learn(pupil, "c") == knownC);
+            REQUIRE(pupil.GetIdeaCount() == 5);
+         }
+
+         THEN("Links between the transferred ideas are restored") {
+            const auto b = Learn(pupil, "b");
+            REQUIRE(knownA->HasAssociation(b));
+            REQUIRE(b->HasAssociation(knownC));
+            REQUIRE(knownC->HasAssociation(Learn(pupil, "d")));
+            REQUIRE(knownA->HasDisassociation(Learn(pupil, "x")));
+            REQUIRE(pupil.GetIdeaCount() == 5);
+         }
+      }
+
+      WHEN("An idea made of other ideas is transferred on its own") {
+         const auto writer = pupil.Write();
+         const auto learned = pupil.Transfer(teacher, Roots({composite}), 1);
+
+         THEN("Its parts are transferred too, and its descriptor refers to them") {
+            REQUIRE(learned.GetCount() == 1);
+            REQUIRE(learned[0]->GetOntology() == &pupil);
+            REQUIRE(pupil.GetIdeaCount() == 3);
+            REQUIRE(pupil.Build(sequence) == learned[0]);
+            REQUIRE(pupil.GetIdeaCount() == 3);
+         }
+      }
+
+      WHEN("Fewer ideas are transferred than are connected") {
+         const auto writer = pupil.Write();
+         const auto learned = pupil.Transfer(teacher, Roots({a}), 3);
+
+         THEN("Ideas are gathered breadth-first until the budget runs out") {
+            REQUIRE(pupil.GetIdeaCount() == 3);
+            const auto b = Learn(pupil, "b");
+            REQUIRE(learned[0]->HasAssociation(b));
+            REQUIRE(learned[0]->HasDisassociation(Learn(pupil, "x")));
+            REQUIRE(pupil.GetIdeaCount() == 3);
+         }
+
+         THEN("Links to ideas that weren't gathered are dropped") {
+            const auto b = Learn(pupil, "b");
+            const auto c = Learn(pupil, "c");
+            REQUIRE(pupil.GetIdeaCount() == 4);
+            REQUIRE_FALSE(b->HasAssociation(c));
+            REQUIRE_FALSE(c->HasAssociation(b));
+         }
+      }
+
+      WHEN("The budget is smaller than the number of roots") {
+         const auto writer = pupil.Write();
+         const auto learned = pupil.Transfer(teacher, Roots({a, composite}), 1);
+
+         THEN("All roots are transferred anyway, in order") {
+            REQUIRE(learned.GetCount() == 2);
+            REQUIRE(learned[0] == Learn(pupil, "a"));
+            REQUIRE(learned[1] == pupil.Build(sequence));
+            REQUIRE(pupil.GetIdeaCount() == 3);
+         }
+      }
+
+      pupil.Teardown();
+      teacher.Teardown();
+   }
+
+   GIVEN("Two minds") {
+      AI module {nullptr, Many {}};
+      auto teacher = CreateMind(module);
+      auto pupil = CreateMind(module);
+      Idea* a;
+      {
+         auto& ontology = teacher->GetOntology();
+         const auto writer = ontology.Write();
+         a = Learn(ontology, "a");
+         a->Associate(Learn(ontology, "b"));
+         Learn(ontology, "b")->Associate(Learn(ontology, "c"));
+      }
+
+      WHEN("One learns from the other, within a budget") {
+         const auto before = pupil->GetOntology().GetIdeaCount();
+         const auto learned = pupil->Learn(*teacher, Roots({a}), 2);
+
+         THEN("It learns the gathered ideas, and the links between them only") {
+            auto& ontology = pupil->GetOntology();
+            const auto writer = ontology.Write();
+            REQUIRE(ontology.GetIdeaCount() == before + 2);
+            REQUIRE(learned[0] == Learn(ontology, "a"));
+            const auto b = Learn(ontology, "b");
+            REQUIRE(learned[0]->HasAssociation(b));
+            REQUIRE_FALSE(b->HasAssociation(Learn(ontology, "c")));
+         }
+      }
+
+      module.Teardown();
+   }
+}
@@ -0,0 +1,105 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2017 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include "../../source/AI.hpp"
+#include <Langulus/Testing.hpp>
+#include <string>
+#include <vector>
+
+
+/// A fingerprint of everything a mind knows and remembers                    
+struct Fingerprint {
+   ::std::vector<::std::uint64_t> mIdeas;
+   Count mRecent = 0;
+   Count mSummaries = 0;
+
+   bool operator == (const Fingerprint&) const = default;
+};
+
+/// Create a number of minds in a module, feed each a different stream of     
+/// creations, update the module a couple of times, and fingerprint them      
+///   @param threads - number of threads to update the minds on               
+///   @return the fingerprints of all minds, in order of creation             
+static auto Simulate(Count threads) -> ::std::vector<Fingerprint> {
+   AI module {nullptr, Many {}};
+   module.SetThreadCount(threads);
+
+   // More minds than fit in a single batch, so that they're really     
+   // updated in parallel                                               
+   ::std::vector<Mind*> minds;
+   for (Count m = 0; m < 200; ++m) {
+      Verbs::Create creation {Construct::From<Mind>()};
+      module.Create(creation);
+      minds.push_back(creation.GetOutput().template As<Mind*>());
+   }
+
+   for (Count frame = 0; frame < 4; ++frame) {
+      for (Offset m = 0; m < minds.size(); ++m) {
+         for (Count e = 0; e < 1 + (m + frame) % 5; ++e) {
+            const auto word = ::std::to_string(m * 31 + frame * 7 + e);
+            Verbs::Create creation {Construct::From<Idea>(Many {Text {word.c_str()}})};
+            minds[m]->Do(creation);
+         }
+      }
+      module.Update({});
+   }
+
+   ::std::vector<Fingerprint> result;
+   for (auto mind : minds) {
+      Fingerprint print;
+      const auto& ontology = mind->GetOntology();
+      for (Offset i = 0; i < ontology.GetIdeaCount(); ++i)
+         print.mIdeas.push_back(ontology.GetIdeaHash(i));
+      print.mRecent = mind->GetHistory().GetCount();
+      print.mSummaries = mind->GetHistory().GetSummaries().size();
+      result.emplace_back(::std::move(print));
+   }
+
+   module.Teardown();
+   return result;
+}
+
+SCENARIO("Work-stealing thread pool", "[ai][workers]") {
+   GIVEN("A function that only touches state owned by its index") {
+      const auto run = [](Count threads, Count batch) {
+         Workers workers;
+         workers.SetThreadCount(threads);
+         ::std::vector<::std::uint64_t> results(1000);
+         workers.ForEach(results.size(), batch, [&](Offset i) {
+            ::std::uint64_t value = i;
+            for (Count step = 0; step < i % 17; ++step)
+               value = value * 6364136223846793005ull + 1442695040888963407ull;
+            results[i] = value;
+         });
+         return results;
+      };
+
+      WHEN("It is run on a single thread, and on many") {
+         const auto sequential = run(1, 16);
+
+         THEN("The results are identical, regardless of batch size") {
+            for (Count threads : {2, 4, 8}) {
+               for (Count batch : {1, 16, 333})
+                  REQUIRE(run(threads, batch) == sequential);
+            }
+         }
+      }
+   }
+
+   GIVEN("A module with many minds, doing different things") {
+      WHEN("The minds are updated sequentially, and in parallel") {
+         const auto sequential = Simulate(1);
+         const auto parallel = Simulate(4);
+
+         THEN("Every mind ends up knowing and remembering the same") {
+            REQUIRE(sequential.size() == parallel.size());
+            for (Offset m = 0; m < sequential.size(); ++m)
+               REQUIRE(sequential[m] == parallel[m]);
+         }
+      }
+   }
+}
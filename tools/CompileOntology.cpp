@@ -0,0 +1,130 @@
+///                                                                           
+/// Langulus::Module::AI                                                      
+/// Copyright (c) 2024 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: GPL-3.0-or-later                                 
+///                                                                           
+#include <Langulus/Entity/Thing.hpp>
+#include <Langulus/Anyness/Bytes.hpp>
+#include <Langulus/Verbs/Interpret.hpp>
+#include <Langulus/AI.hpp>
+#include <fstream>
+#include <string>
+
+using namespace Langulus;
+
+LANGULUS_RTTI_BOUNDARY(RTTI::MainBoundary)
+
+
+/// Get an image of the ontology of the mind inside an entity                 
+///   @param root - the entity with the mind                                  
+///   @return the image, or nothing if the mind didn't produce one            
+static auto Introspect(Thing& root) -> Bytes {
+   // Interpreting the mind as bytes gives an image of its ontology,    
+   // so that nothing inside the module is reached into directly        
+   Verbs::Interpret interpret {MetaDataOf<Bytes>()};
+   root.Run(interpret);
+   const auto& output = interpret.GetOutput();
+   if (not output.template Is<Bytes>() or output.IsEmpty())
+      return {};
+   return output.template As<Bytes>();
+}
+
+///                                                                           
+///   Ontology compiler                                                       
+///                                                                           
+/// Executes a definitions file inside a mind, and saves the resulting        
+/// ontology as a binary snapshot, that can be embedded into an application   
+/// and installed without parsing anything at runtime.                        
+///                                                                           
+///   Usage: LangulusModAICompiler <definitions> <image> [module...]          
+///                                                                           
+/// Each definition starts on a new line with ##, and continues until the     
+/// next definition. Lines starting with // are ignored. Any additional       
+/// modules are loaded before executing the definitions, so that the types    
+/// they reflect can be used in the definitions.                              
+/// The image is then installed in another mind, which has to end up with     
+/// exactly the same ideas and links, or the image isn't written at all.      
+///                                                                           
+int main(int argc, char** argv) {
+   if (argc < 3) {
+      Logger::Error("Usage: LangulusModAICompiler <definitions> <image> [module...]");
+      return 1;
+   }
+
+   std::ifstream definitions {argv[1]};
+   if (not definitions) {
+      Logger::Error("Can't open definitions file `", argv[1], '`');
+      return 1;
+   }
+
+   // Create the root entity and a mind to build the ontology in        
+   auto root = Thing::Root("AI");
+   for (int i = 3; i < argc; ++i)
+      root.LoadMod(argv[i]);
+   root.CreateUnit<A::Mind>();
+
+   // Gather multi-line definitions and execute them one by one         
+   Count executed = 0;
+   std::string line, statement;
+   const auto execute = [&] {
+      if (statement.empty())
+         return;
+      root.Run(Code {statement.c_str()});
+      statement.clear();
+      ++executed;
+   };
+
+   while (std::getline(definitions, line)) {
+      const auto start = line.find_first_not_of(" \t\r");
+      if (start == std::string::npos or line.compare(start, 2, "//") == 0)
+         continue;
+
+      if (line.compare(start, 2, "##") == 0)
+         execute();
+      else if (statement.empty()) {
+         Logger::Error("Definition expected at: ", line.c_str());
+         return 1;
+      }
+
+      statement += line;
+      statement += ' ';
+   }
+   execute();
+
+   const auto image = Introspect(root);
+   if (not image) {
+      Logger::Error("The mind didn't produce an ontology image");
+      return 1;
+   }
+
+   // Install the image the way applications do, and make sure that it  
+   // describes the same ideas and links - images are made in order of  
+   // creation, so imaging the installed ontology again gives the same  
+   // bytes only if it is identical to the one that ran the definitions 
+   {
+      auto check = Thing::Root("AI check");
+      for (int i = 3; i < argc; ++i)
+         check.LoadMod(argv[i]);
+      check.CreateUnit<A::Mind>(image);
+
+      if (Introspect(check) != image) {
+         Logger::Error("Installing the image of `", argv[1], "` doesn't "
+            "give the same ideas and links as running the definitions");
+         return 1;
+      }
+   }
+
+   std::ofstream file {argv[2], std::ios::binary};
+   file.write(reinterpret_cast<const char*>(image.GetRaw()),
+      static_cast<std::streamsize>(image.GetCount()));
+   if (not file) {
+      Logger::Error("Can't write ontology image `", argv[2], '`');
+      return 1;
+   }
+
+   Logger::Info("Compiled ", executed, " definitions from `", argv[1],
+      "` into `", argv[2], '`');
+   return 0;
+}